@@ -0,0 +1,166 @@
+#include <Lab1/3rdparty/lyra/lyra.hpp>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/address.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/system/error_code.hpp>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Amount of connections opened from a single source address,
+     *  so ephemeral ports aren't exhausted.
+     */
+    constexpr size_t kConnectionsPerSource = 20'000;
+
+    /**
+     * @brief Resident set size of process @a pid in kilobytes.
+     */
+    [[nodiscard]]
+    auto resident(const pid_t pid) -> std::optional<size_t>
+    {
+        std::ifstream status{"/proc/" + std::to_string(pid) + "/status"};
+        std::string key;
+        while (status >> key) {
+            if (key == "VmRSS:") {
+                size_t kilobytes;
+                status >> kilobytes;
+                return kilobytes;
+            }
+            status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        return {};
+    }
+
+    /**
+     * @brief Allow to open as many descriptors as system permits.
+     */
+    void raise_descriptors_limit() noexcept
+    {
+        rlimit limit;
+        if (::getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+            limit.rlim_cur = limit.rlim_max;
+            ::setrlimit(RLIMIT_NOFILE, &limit);
+        }
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    uint16_t port = 20'003;
+    std::string host = "127.0.0.1";
+    size_t connections = 100'000;
+    pid_t pid = 0;
+    bool show_help = false;
+
+    auto cli
+        = lyra::opt(port, "port")
+            ["-p"]["--port"]
+            ("Port of the server [default: 20003]")
+        | lyra::opt(host, "host")
+            ["-h"]["--host"]
+            ("Address of the server [default: 127.0.0.1]")
+        | lyra::opt(connections, "amount")
+            ["-n"]["--connections"]
+            ("Amount of idle connections to open [default: 100000]")
+        | lyra::opt(pid, "pid")
+            ["--pid"]
+            ("Process of the server to measure resident size of")
+        | lyra::help(show_help)
+            ("Show help message");
+
+    auto result = cli.parse({argc, argv});
+    if (!result) {
+        std::cerr << "Error in command line: " << result.errorMessage() << std::endl;
+        return 1;
+    }
+
+    if (show_help) {
+        std::cout << cli << std::endl;
+        return 0;
+    }
+
+    raise_descriptors_limit();
+
+    const auto address = boost::asio::ip::make_address(host);
+    std::optional<size_t> before;
+    if (pid) {
+        before = resident(pid);
+    }
+
+    boost::asio::io_context context;
+    std::vector<boost::asio::ip::tcp::socket> sockets;
+    sockets.reserve(connections);
+    std::string buffer;
+
+    const auto started = Clock::now();
+    for (size_t i = 0; i < connections; ++i) {
+        boost::system::error_code ec;
+        auto& socket = sockets.emplace_back(context);
+        socket.open(address.is_v4() ? boost::asio::ip::tcp::v4() : boost::asio::ip::tcp::v6(), ec);
+        if (!ec && address.is_loopback() && address.is_v4()) {
+            /// Whole 127.0.0.0/8 network is routed to loopback,
+            /// ports left in TIME_WAIT by previous runs are reused
+            socket.set_option(boost::asio::socket_base::reuse_address{true}, ec);
+            const auto source = static_cast<uint32_t>(address.to_v4().to_uint() + 1 + i / kConnectionsPerSource);
+            socket.bind({boost::asio::ip::address_v4{source}, 0}, ec);
+        }
+
+        if (!ec) {
+            socket.connect({address, port}, ec);
+        }
+
+        if (!ec) {
+            /// Empty line tells server at once that client speaks text
+            boost::asio::write(socket, boost::asio::buffer("\n", 1), ec);
+        }
+
+        if (!ec) {
+            /// Session is started once it has greeted client
+            buffer.clear();
+            boost::asio::read_until(socket, boost::asio::dynamic_buffer(buffer), "input> ", ec);
+        }
+
+        if (ec) {
+            std::cerr << "Connection #" << i << " failed with message: " << ec.message() << std::endl;
+            sockets.pop_back();
+            break;
+        }
+    }
+    const auto elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+
+    std::cout << "Opened " << sockets.size() << " idle connections in "
+              << std::fixed << std::setprecision(1) << elapsed << " s" << std::endl;
+
+    std::optional<size_t> after;
+    if (pid) {
+        after = resident(pid);
+    }
+    if (before && after) {
+        std::cout << "Server resident size grew from " << *before << " KB to " << *after << " KB";
+        if (!sockets.empty()) {
+            const auto per_connection = (static_cast<double>(*after) - *before) * 1024 / sockets.size();
+            std::cout << ", " << std::setprecision(0) << per_connection << " bytes per connection";
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include <Lab1/3rdparty/lyra/lyra.hpp>
+
+#include <array>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/address.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/system/error_code.hpp>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Byte selecting binary protocol.
+     */
+    constexpr uint8_t kBinaryMagic = 0xB1;
+
+    /**
+     * @brief Request @c OR of case 0 with id 1, answered from cache once
+     *  it is evaluated, so server does nothing but I/O.
+     */
+    constexpr std::array<uint8_t, 4> kRequest{3, 0x00, 1, 0};
+
+    /**
+     * @brief CPU time consumed by a process.
+     */
+    struct Usage
+    {
+        double user;
+        double system;
+    };
+
+    /**
+     * @brief User and system time of process @a pid in seconds.
+     */
+    [[nodiscard]]
+    auto usage(const pid_t pid) -> std::optional<Usage>
+    {
+        std::ifstream stat{"/proc/" + std::to_string(pid) + "/stat"};
+        std::string line;
+        if (!std::getline(stat, line)) {
+            return {};
+        }
+
+        /// Name of process may contain spaces, so fields are counted from its end
+        const auto end = line.rfind(')');
+        if (end == std::string::npos) {
+            return {};
+        }
+
+        std::istringstream fields{line.substr(end + 2)};
+        std::string field;
+        /// Fields 3 to 13 precede user time
+        for (int i = 3; i < 14 && fields >> field; ++i) { }
+
+        uint64_t user;
+        uint64_t system;
+        if (!(fields >> user >> system)) {
+            return {};
+        }
+
+        const auto ticks = static_cast<double>(::sysconf(_SC_CLK_TCK));
+        return Usage{user / ticks, system / ticks};
+    }
+
+    /**
+     * @brief Allow to open as many descriptors as system permits.
+     */
+    void raise_descriptors_limit() noexcept
+    {
+        rlimit limit;
+        if (::getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+            limit.rlim_cur = limit.rlim_max;
+            ::setrlimit(RLIMIT_NOFILE, &limit);
+        }
+    }
+
+    /**
+     * @brief Send request over every connection, then read every reply.
+     */
+    void round(std::vector<boost::asio::ip::tcp::socket>& sockets, boost::system::error_code& ec)
+    {
+        for (auto& socket : sockets) {
+            boost::asio::write(socket, boost::asio::buffer(kRequest), ec);
+            if (ec) {
+                return;
+            }
+        }
+
+        std::array<uint8_t, 256> reply;
+        for (auto& socket : sockets) {
+            boost::asio::read(socket, boost::asio::buffer(reply.data(), 1), ec);
+            if (!ec) {
+                boost::asio::read(socket, boost::asio::buffer(reply.data() + 1, reply[0]), ec);
+            }
+
+            if (ec) {
+                return;
+            }
+        }
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    uint16_t port = 20'003;
+    std::string host = "127.0.0.1";
+    size_t connections = 100;
+    size_t rounds = 1'000;
+    pid_t pid = 0;
+    bool show_help = false;
+
+    auto cli
+        = lyra::opt(port, "port")
+            ["-p"]["--port"]
+            ("Port of the server [default: 20003]")
+        | lyra::opt(host, "host")
+            ["-h"]["--host"]
+            ("Address of the server [default: 127.0.0.1]")
+        | lyra::opt(connections, "amount")
+            ["-n"]["--connections"]
+            ("Amount of connections sending requests [default: 100]")
+        | lyra::opt(rounds, "amount")
+            ["-r"]["--rounds"]
+            ("Amount of requests sent over every connection [default: 1000]")
+        | lyra::opt(pid, "pid")
+            ["--pid"]
+            ("Process of the server to measure CPU time of")
+        | lyra::help(show_help)
+            ("Show help message");
+
+    auto result = cli.parse({argc, argv});
+    if (!result) {
+        std::cerr << "Error in command line: " << result.errorMessage() << std::endl;
+        return 1;
+    }
+
+    if (show_help) {
+        std::cout << cli << std::endl;
+        return 0;
+    }
+
+    raise_descriptors_limit();
+
+    const auto address = boost::asio::ip::make_address(host);
+    boost::asio::io_context context;
+    std::vector<boost::asio::ip::tcp::socket> sockets;
+    sockets.reserve(connections);
+    boost::system::error_code ec;
+    for (size_t i = 0; i < connections; ++i) {
+        auto& socket = sockets.emplace_back(context);
+        socket.connect({address, port}, ec);
+        if (!ec) {
+            socket.set_option(boost::asio::ip::tcp::no_delay{true}, ec);
+        }
+        if (!ec) {
+            boost::asio::write(socket, boost::asio::buffer(&kBinaryMagic, 1), ec);
+        }
+
+        if (ec) {
+            std::cerr << "Connection #" << i << " failed with message: " << ec.message() << std::endl;
+            return 1;
+        }
+    }
+
+    /// The first request is evaluated, the rest are answered from cache
+    round(sockets, ec);
+    if (ec) {
+        std::cerr << "Warm-up failed with message: " << ec.message() << std::endl;
+        return 1;
+    }
+
+    const std::optional<Usage> before = pid ? usage(pid) : std::nullopt;
+    const auto started = Clock::now();
+    for (size_t i = 0; i < rounds; ++i) {
+        round(sockets, ec);
+        if (ec) {
+            std::cerr << "Round #" << i << " failed with message: " << ec.message() << std::endl;
+            return 1;
+        }
+    }
+    const auto elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+    const auto requests = static_cast<double>(connections * rounds);
+
+    std::cout << "Served " << connections * rounds << " requests over " << connections << " connections in "
+              << std::fixed << std::setprecision(2) << elapsed << " s, "
+              << std::setprecision(0) << requests / elapsed << " requests/s" << std::endl;
+
+    const std::optional<Usage> after = pid ? usage(pid) : std::nullopt;
+    if (before && after && requests > 0) {
+        std::cout << "Server spent " << std::setprecision(2)
+                  << (after->user - before->user) * 1e6 / requests << " us user and "
+                  << (after->system - before->system) * 1e6 / requests << " us system time per request"
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include <Lab1/Execution/Pidfd.hpp>
+#include <Lab1/Execution/Spawner.hpp>
+#include <Lab1/Execution/Zygote.hpp>
+
+#include <Lab1/3rdparty/lyra/lyra.hpp>
+
+#include <algorithm>
+#include <boost/asio/io_context.hpp>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Job which never finishes, so children live until killed.
+     */
+    const lab1::Job kJob{lab1::Mul{}, lab1::Function::F, 3};
+
+    /**
+     * @brief Terminate and collect child created by spawner.
+     */
+    void dispose(const lab1::Child& child) noexcept
+    {
+        if (child.pidfd >= 0) {
+            lab1::pidfd::send_signal(child.pidfd, SIGKILL);
+            ::close(child.pidfd);
+        } else {
+            ::kill(child.pid, SIGKILL);
+            ::waitpid(child.pid, nullptr, 0);
+        }
+        ::close(child.fd);
+    }
+
+    /**
+     * @brief Measure @a iterations of @a spawn, microseconds each.
+     */
+    [[nodiscard]]
+    auto measure(const size_t iterations, const std::function<void()>& spawn) -> std::vector<double>
+    {
+        std::vector<double> samples;
+        samples.reserve(iterations);
+        for (size_t i = 0; i < iterations; ++i) {
+            const auto started = Clock::now();
+            spawn();
+            samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - started).count());
+        }
+        return samples;
+    }
+
+    void report(const size_t megabytes, const std::string& method, std::vector<double> samples)
+    {
+        std::sort(samples.begin(), samples.end());
+        const auto mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+        std::cout << std::setw(8) << megabytes
+                  << std::setw(10) << method
+                  << std::setw(14) << std::fixed << std::setprecision(1) << samples[samples.size() / 2]
+                  << std::setw(14) << mean
+                  << std::setw(14) << samples.back()
+                  << std::endl;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<size_t> sizes;
+    size_t iterations = 50;
+    std::string worker_executable = (std::filesystem::read_symlink("/proc/self/exe").parent_path() / "lab1worker").string();
+    bool show_help = false;
+
+    auto cli
+        = lyra::opt(sizes, "megabytes")
+            ["-s"]["--size"]
+            ("Resident size of the parent to measure at, may be repeated [default: 10 100 500 1000 2000]")
+        | lyra::opt(iterations, "amount")
+            ["-n"]["--iterations"]
+            ("Amount of children to spawn per method and size [default: 50]")
+        | lyra::opt(worker_executable, "path")
+            ["--worker-executable"]
+            ("Path to worker executable [default: lab1worker next to benchmark]")
+        | lyra::help(show_help)
+            ("Show help message");
+
+    auto result = cli.parse({argc, argv});
+    if (!result) {
+        std::cerr << "Error in command line: " << result.errorMessage() << std::endl;
+        return 1;
+    }
+
+    if (show_help) {
+        std::cout << cli << std::endl;
+        return 0;
+    }
+
+    if (sizes.empty()) {
+        sizes = {10, 100, 500, 1000, 2000};
+    }
+
+    /// Zygote is forked while benchmark is tiny, as server does
+    lab1::Zygote zygote;
+    boost::asio::io_context context;
+    lab1::ZygoteSpawner zygote_spawner{context, zygote, 0};
+    lab1::ForkSpawner fork_spawner{context};
+    lab1::CloneSpawner clone_spawner{worker_executable};
+    lab1::PosixSpawner posix_spawner{worker_executable};
+
+    std::cout << std::setw(8) << "RSS, MB"
+              << std::setw(10) << "method"
+              << std::setw(14) << "median, us"
+              << std::setw(14) << "mean, us"
+              << std::setw(14) << "max, us"
+              << std::endl;
+
+    for (const auto megabytes : sizes) {
+        /// Grow resident set of the parent
+        const auto bytes = megabytes * 1024 * 1024;
+        void* ballast = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ballast == MAP_FAILED) {
+            std::cerr << "Can't allocate " << megabytes << " MB" << std::endl;
+            return 1;
+        }
+        std::memset(ballast, 1, bytes);
+
+        std::vector<pid_t> forked;
+        forked.reserve(iterations);
+        auto samples = measure(iterations, [&] {
+            const auto pid = ::fork();
+            if (pid == 0) {
+                ::_exit(0);
+            }
+            forked.push_back(pid);
+        });
+        for (const auto pid : forked) {
+            ::waitpid(pid, nullptr, 0);
+        }
+        report(megabytes, "fork", std::move(samples));
+
+        const std::pair<const char*, lab1::Spawner*> spawners[] = {
+            {"current", &fork_spawner},
+            {"zygote", &zygote_spawner},
+            {"clone", &clone_spawner},
+            {"spawn", &posix_spawner}
+        };
+        for (const auto& [method, spawner] : spawners) {
+            std::vector<lab1::Child> children;
+            children.reserve(iterations);
+            auto samples = measure(iterations, [&, spawner = spawner] {
+                if (auto child = spawner->spawn(kJob, nullptr)) {
+                    children.push_back(*child);
+                }
+            });
+            for (const auto& child : children) {
+                dispose(child);
+            }
+            report(megabytes, method, std::move(samples));
+        }
+
+        ::munmap(ballast, bytes);
+    }
+
+    return 0;
+}
@@ -0,0 +1,253 @@
+#include <Lab1/Execution/Admission.hpp>
+
+#include <algorithm>
+#include <boost/asio/post.hpp>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace lab1 {
+
+Admission::Admission(const size_t limit,
+                     const size_t capacity,
+                     const std::chrono::milliseconds aging) noexcept :
+    _limit{limit},
+    _capacity{capacity},
+    _aging{aging}
+{ }
+
+auto Admission::enter(const Origin& origin,
+                      boost::asio::io_context& context,
+                      Granted granted,
+                      Ticket& ticket) -> Entry
+{
+    std::lock_guard lock{_mutex};
+    if (_running < _limit) {
+        ++_running;
+        return Entry::Granted;
+    }
+
+    if (_waiters.size() >= _capacity) {
+        return Entry::Rejected;
+    }
+
+    ticket = _next++;
+    _waiters.emplace(ticket, Waiter{origin, context, std::move(granted)});
+
+    auto& queue = _queues[static_cast<size_t>(origin.priority)];
+    queue.queued.emplace(ticket, Clock::now());
+    auto& flow = queue.flows[origin.client];
+    if (flow.sessions.empty()) {
+        /// Client takes its turn after everybody waiting
+        queue.active.push_back(origin.client);
+    }
+    flow.weight = std::max<size_t>(1, origin.weight);
+    flow.sessions[origin.session].push_back(ticket);
+    return Entry::Queued;
+}
+
+bool Admission::leave(const Ticket ticket)
+{
+    std::lock_guard lock{_mutex};
+    const auto waiter = _waiters.find(ticket);
+    if (waiter == _waiters.end()) {
+        return false;
+    }
+
+    const auto origin = waiter->second.origin;
+    _waiters.erase(waiter);
+
+    auto& queue = _queues[static_cast<size_t>(origin.priority)];
+    queue.queued.erase(ticket);
+    auto& flow = queue.flows.at(origin.client);
+    auto& jobs = flow.sessions.at(origin.session);
+    jobs.erase(std::find(jobs.begin(), jobs.end(), ticket));
+    if (jobs.empty()) {
+        flow.sessions.erase(origin.session);
+    }
+
+    if (flow.sessions.empty()) {
+        queue.flows.erase(origin.client);
+        queue.active.erase(std::find(queue.active.begin(), queue.active.end(), origin.client));
+    }
+    return true;
+}
+
+void Admission::release()
+{
+    std::unique_lock lock{_mutex};
+    if (_waiters.empty()) {
+        --_running;
+        return;
+    }
+
+    /// Slot is handed over to the chosen job
+    auto node = _waiters.extract(_pop(_choose()));
+    lock.unlock();
+
+    auto& waiter = node.mapped();
+    boost::asio::post(waiter.context, std::move(waiter.granted));
+}
+
+auto Admission::_choose() -> Queue&
+{
+    /// Class is promoted by one for every aging period its oldest job waits
+    const auto now = Clock::now();
+    Queue* chosen = nullptr;
+    size_t urgency = SIZE_MAX;
+    for (size_t priority = 0; priority < _queues.size(); ++priority) {
+        auto& queue = _queues[priority];
+        if (queue.queued.empty()) {
+            continue;
+        }
+
+        const auto waited = now - queue.queued.begin()->second;
+        const auto promotion = _aging.count() > 0 ? static_cast<size_t>(waited / _aging) : 0;
+        const auto current = priority - std::min(priority, promotion);
+        if (current < urgency) {
+            urgency = current;
+            chosen = &queue;
+        }
+    }
+
+    return *chosen;
+}
+
+auto Admission::_pop(Queue& queue) -> Ticket
+{
+    /// Client whose turn it is gets slots in proportion to its weight
+    const auto client = queue.active.front();
+    auto& flow = queue.flows.at(client);
+    if (flow.deficit == 0) {
+        flow.deficit = flow.weight;
+    }
+
+    /// Sessions of a client take turns as well
+    auto session = flow.sessions.upper_bound(flow.last);
+    if (session == flow.sessions.end()) {
+        session = flow.sessions.begin();
+    }
+
+    const auto ticket = session->second.front();
+    session->second.pop_front();
+    flow.last = session->first;
+    if (session->second.empty()) {
+        flow.sessions.erase(session);
+    }
+
+    if (flow.sessions.empty()) {
+        queue.flows.erase(client);
+        queue.active.pop_front();
+    } else if (--flow.deficit == 0) {
+        queue.active.pop_front();
+        queue.active.push_back(client);
+    }
+
+    queue.queued.erase(ticket);
+    return ticket;
+}
+
+/**
+ * @brief State shared between task and pending callbacks.
+ */
+struct AdmissionBackend::State
+{
+    State(const Job& job, Handler handler) :
+        job{job},
+        handler{std::move(handler)}
+    { }
+
+    const Job job;
+    Handler handler;
+    std::unique_ptr<Task> task;
+    Admission::Ticket ticket = 0;
+    Phase phase = Phase::Queued;
+};
+
+/**
+ * @brief Job holding or waiting for a slot.
+ */
+class AdmissionBackend::AdmittedTask final: public Backend::Task
+{
+public:
+    AdmittedTask(Admission& admission, std::shared_ptr<State> state) noexcept :
+        _admission{admission},
+        _state{std::move(state)}
+    { }
+
+    ~AdmittedTask() noexcept override
+    {
+        /// Cancel job before its slot is taken by another one
+        _state->handler = nullptr;
+        _state->task.reset();
+        if (_state->phase == Phase::Running) {
+            _admission.release();
+        } else if (_state->phase == Phase::Queued) {
+            /// Slot granted meanwhile is released by its callback
+            _admission.leave(_state->ticket);
+        }
+    }
+
+private:
+    Admission& _admission;
+    std::shared_ptr<State> _state;
+};
+
+AdmissionBackend::AdmissionBackend(boost::asio::io_context& context,
+                                   Backend& backend,
+                                   Admission& admission) noexcept :
+    _context{context},
+    _backend{backend},
+    _admission{admission}
+{ }
+
+auto AdmissionBackend::submit(const Job& job, Handler handler) -> std::unique_ptr<Task>
+{
+    auto state = std::make_shared<State>(job, std::move(handler));
+    const auto entry = _admission.enter(
+        job.origin,
+        _context,
+        [this, weak = std::weak_ptr<State>{state}] {
+            if (const auto state = weak.lock()) {
+                _start(state);
+            } else {
+                /// Job is canceled while slot was being granted
+                _admission.release();
+            }
+        },
+        state->ticket
+    );
+
+    if (entry == Admission::Entry::Rejected) {
+        return nullptr;
+    }
+
+    if (entry == Admission::Entry::Granted) {
+        _start(state);
+    }
+    return std::make_unique<AdmittedTask>(_admission, std::move(state));
+}
+
+void AdmissionBackend::_start(const std::shared_ptr<State>& state)
+{
+    state->phase = Phase::Running;
+    state->task = _backend.submit(
+        state->job,
+        [this, weak = std::weak_ptr<State>{state}] (const std::optional<int64_t> result) {
+            const auto state = weak.lock();
+            if (!state || state->phase != Phase::Running) {
+                return;
+            }
+
+            /// Slot is free once job is finished
+            state->phase = Phase::Finished;
+            _admission.release();
+            if (auto handler = std::exchange(state->handler, nullptr)) {
+                handler(result);
+            }
+        }
+    );
+}
+
+} // namespace lab1
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <Lab1/Execution/Backend.hpp>
+
+#include <array>
+#include <boost/asio/io_context.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace lab1 {
+
+/**
+ * @brief Limit of jobs being executed simultaneously by all event loops.
+ *
+ * Jobs exceeding the limit wait for a free slot in a bounded queue, jobs
+ * exceeding the queue are rejected. Free slots are given to jobs of the
+ * most urgent priority class first, but class whose oldest job waits
+ * for long is considered as urgent as the next one for every aging
+ * period passed, so no class starves. Within a class slots are shared
+ * between clients by deficit round robin in proportion to their
+ * weights, every job costing a single slot, while sessions of a client
+ * take turns. Jobs of a session are started in order. Safe to use from
+ * multiple threads.
+ */
+class Admission
+{
+public:
+    /**
+     * @brief Position of a job in queue.
+     */
+    using Ticket = uint64_t;
+
+    /**
+     * @brief Callback notified once queued job is granted a slot.
+     */
+    using Granted = std::function<void()>;
+
+    /**
+     * @brief Outcome of entering.
+     */
+    enum class Entry
+    {
+        /// Slot is taken
+        Granted,
+        /// Job waits for a slot
+        Queued,
+        /// Queue is full
+        Rejected
+    };
+
+    /**
+     * @brief Default time job waits for before its class is promoted.
+     */
+    static constexpr std::chrono::milliseconds kDefaultAging{2000};
+
+    /**
+     * @param limit Maximal amount of jobs being executed.
+     * @param capacity Maximal amount of jobs waiting for a slot.
+     * @param aging Time job waits for before its class is promoted.
+     */
+    Admission(size_t limit,
+              size_t capacity,
+              std::chrono::milliseconds aging = kDefaultAging) noexcept;
+
+    Admission(const Admission&) = delete;
+    Admission& operator=(const Admission&) = delete;
+
+    /**
+     * @brief Take a slot or queue for it.
+     * @param origin Client job is executed for.
+     * @param granted Posted to @a context once queued job is granted
+     *  a slot. It must release the slot if job isn't needed anymore.
+     * @param ticket Set if job is queued.
+     */
+    [[nodiscard]]
+    auto enter(const Origin& origin,
+               boost::asio::io_context& context,
+               Granted granted,
+               Ticket& ticket) -> Entry;
+
+    /**
+     * @brief Leave queue.
+     * @return Whether job was still queued, otherwise slot is
+     *  already granted to it.
+     */
+    bool leave(Ticket ticket);
+
+    /**
+     * @brief Return slot, so a queued job of the client
+     *  whose turn it is is granted it.
+     */
+    void release();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Waiter
+    {
+        Origin origin;
+        boost::asio::io_context& context;
+        Granted granted;
+    };
+
+    /**
+     * @brief Jobs of a client waiting for a slot.
+     */
+    struct Flow
+    {
+        size_t weight = 1;
+        /// Slots client is allowed to take during its turn
+        size_t deficit = 0;
+        /// Jobs by session, oldest first
+        std::map<uint64_t, std::deque<Ticket>> sessions;
+        /// Session served last
+        uint64_t last = 0;
+    };
+
+    /**
+     * @brief Jobs of a priority class waiting for a slot.
+     */
+    struct Queue
+    {
+        std::unordered_map<uint64_t, Flow> flows;
+        /// Clients having queued jobs in order of their turns
+        std::deque<uint64_t> active;
+        /// Time jobs are queued at, oldest first
+        std::map<Ticket, Clock::time_point> queued;
+    };
+
+    /**
+     * @brief Choose queue whose job is granted a slot.
+     */
+    [[nodiscard]]
+    auto _choose() -> Queue&;
+
+    /**
+     * @brief Take job whose turn it is out of @a queue.
+     */
+    [[nodiscard]]
+    static auto _pop(Queue& queue) -> Ticket;
+
+private:
+    size_t _limit;
+    size_t _capacity;
+    std::chrono::milliseconds _aging;
+    std::mutex _mutex;
+    size_t _running = 0;
+    std::unordered_map<Ticket, Waiter> _waiters;
+    /// Queues by priority class
+    std::array<Queue, kPriorities> _queues;
+    Ticket _next = 0;
+};
+
+/**
+ * @brief Backend executing jobs only once they are admitted.
+ *
+ * Rejected jobs aren't submitted, null task is returned instead.
+ */
+class AdmissionBackend final: public Backend
+{
+public:
+    /**
+     * @param context Event loop results are delivered to.
+     * @param backend Backend executing admitted jobs.
+     * @param admission Limit shared by event loops.
+     */
+    AdmissionBackend(boost::asio::io_context& context, Backend& backend, Admission& admission) noexcept;
+
+    AdmissionBackend(const AdmissionBackend&) = delete;
+    AdmissionBackend& operator=(const AdmissionBackend&) = delete;
+
+    [[nodiscard]]
+    auto submit(const Job& job, Handler handler) -> std::unique_ptr<Task> override;
+
+private:
+    class AdmittedTask;
+
+    /**
+     * @brief Stage of job admission.
+     */
+    enum class Phase
+    {
+        Queued,
+        Running,
+        Finished
+    };
+
+    struct State;
+
+    /**
+     * @brief Execute job holding a slot.
+     */
+    void _start(const std::shared_ptr<State>& state);
+
+private:
+    boost::asio::io_context& _context;
+    Backend& _backend;
+    Admission& _admission;
+};
+
+} // namespace lab1
@@ -0,0 +1,6 @@
+#pragma once
+
+/// Boost 1.74 uses std::exchange in awaitable without including <utility>
+#include <utility>
+
+#include <boost/asio/awaitable.hpp>
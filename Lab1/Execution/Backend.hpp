@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Lab1/Execution/Job.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+
+namespace lab1 {
+
+/**
+ * @brief Facility executing jobs asynchronously.
+ */
+class Backend
+{
+public:
+    /**
+     * @brief Callback receiving raw value of a job result, see
+     *  @a evaluate_value, or an empty optional if job has failed.
+     */
+    using Handler = std::function<void(std::optional<int64_t>)>;
+
+    /**
+     * @brief Handle of submitted job.
+     * @note Destroying a task cancels the job and guarantees
+     *  that its handler won't be invoked anymore.
+     */
+    class Task
+    {
+    public:
+        virtual ~Task() = default;
+    };
+
+    virtual ~Backend() = default;
+
+    /**
+     * @brief Start execution of @a job.
+     * @param handler Invoked from event loop once job is finished.
+     * @return Handle to control job lifetime or null if backend is too
+     *  busy to accept job, handler is never invoked then.
+     */
+    [[nodiscard]]
+    virtual auto submit(const Job& job, Handler handler) -> std::unique_ptr<Task> = 0;
+};
+
+} // namespace lab1
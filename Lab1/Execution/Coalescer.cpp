@@ -0,0 +1,114 @@
+#include <Lab1/Execution/Coalescer.hpp>
+
+#include <utility>
+
+namespace lab1 {
+
+/**
+ * @brief Handle of a single subscriber of a job.
+ */
+class Coalescer::Subscription final: public Backend::Task
+{
+public:
+    Subscription(Coalescer& coalescer,
+                 const Key key,
+                 std::weak_ptr<Flight> flight,
+                 const uint64_t subscriber) noexcept :
+        _coalescer{coalescer},
+        _key{key},
+        _flight{std::move(flight)},
+        _subscriber{subscriber}
+    { }
+
+    ~Subscription() noexcept override
+    {
+        if (const auto flight = _flight.lock()) {
+            _coalescer._unsubscribe(_key, flight, _subscriber);
+        }
+    }
+
+private:
+    Coalescer& _coalescer;
+    Key _key;
+    std::weak_ptr<Flight> _flight;
+    uint64_t _subscriber;
+};
+
+Coalescer::Coalescer(Backend& backend) noexcept :
+    _backend{backend}
+{ }
+
+auto Coalescer::submit(const Job& job, Handler handler) -> std::unique_ptr<Task>
+{
+    const auto key = _key(job);
+    auto& flight = _flights[key];
+    const bool started = flight != nullptr;
+    if (!started) {
+        flight = std::make_shared<Flight>();
+    }
+
+    /// Subscribe before job is started, in case it finishes at once
+    const auto current = flight;
+    const auto subscriber = current->next++;
+    current->subscribers.emplace(subscriber, std::move(handler));
+    if (!started) {
+        current->task = _backend.submit(
+            job,
+            [this, key] (const std::optional<int64_t> result) {
+                _finish(key, result);
+            }
+        );
+
+        if (!current->task) {
+            /// Nobody else could subscribe to rejected job yet
+            _flights.erase(key);
+            return nullptr;
+        }
+    }
+
+    return std::make_unique<Subscription>(*this, key, current, subscriber);
+}
+
+auto Coalescer::_key(const Job& job) noexcept -> Key
+{
+    /// Urgent request never waits for a job queued in a lower class
+    return static_cast<Key>(job.origin.priority) << 48
+        | static_cast<Key>(job.operation.index()) << 40
+        | static_cast<Key>(job.function) << 32
+        | static_cast<uint32_t>(job.index);
+}
+
+void Coalescer::_finish(const Key key, const std::optional<int64_t> result)
+{
+    const auto found = _flights.find(key);
+    if (found == _flights.end()) {
+        return;
+    }
+
+    /// Identical jobs submitted since now are executed again
+    const auto flight = std::move(found->second);
+    _flights.erase(found);
+    flight->finished = true;
+
+    /// Subscribers may unsubscribe each other meanwhile
+    while (!flight->subscribers.empty()) {
+        auto node = flight->subscribers.extract(flight->subscribers.begin());
+        node.mapped()(result);
+    }
+}
+
+void Coalescer::_unsubscribe(const Key key, const std::shared_ptr<Flight>& flight, const uint64_t subscriber)
+{
+    flight->subscribers.erase(subscriber);
+    if (!flight->subscribers.empty() || flight->finished) {
+        return;
+    }
+
+    /// Nobody waits for job anymore, so it is canceled
+    /// once flight is released
+    if (const auto found = _flights.find(key); found != _flights.end() && found->second == flight) {
+        _flights.erase(found);
+    }
+}
+
+} // namespace lab1
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Lab1/Execution/Backend.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+namespace lab1 {
+
+/**
+ * @brief Backend sharing evaluation of identical jobs between requests.
+ *
+ * The first job submitted for a function of an operation on a case is
+ * executed by underlying backend, while identical jobs submitted until
+ * it is finished subscribe to its result. Job is canceled only once
+ * every subscriber cancels it, so amount of jobs being executed is
+ * bounded by amount of distinct ones.
+ */
+class Coalescer final: public Backend
+{
+public:
+    /**
+     * @param backend Backend executing distinct jobs.
+     */
+    explicit Coalescer(Backend& backend) noexcept;
+
+    Coalescer(const Coalescer&) = delete;
+    Coalescer& operator=(const Coalescer&) = delete;
+
+    [[nodiscard]]
+    auto submit(const Job& job, Handler handler) -> std::unique_ptr<Task> override;
+
+private:
+    class Subscription;
+
+    using Key = uint64_t;
+
+    /**
+     * @brief Job being executed with everybody waiting for it.
+     */
+    struct Flight
+    {
+        std::unique_ptr<Task> task;
+        std::map<uint64_t, Handler> subscribers;
+        uint64_t next = 0;
+        bool finished = false;
+    };
+
+    [[nodiscard]]
+    static auto _key(const Job& job) noexcept -> Key;
+
+    /**
+     * @brief Deliver result of job to every subscriber.
+     */
+    void _finish(Key key, std::optional<int64_t> result);
+
+    /**
+     * @brief Forget subscriber, cancel job if nobody waits for it.
+     */
+    void _unsubscribe(Key key, const std::shared_ptr<Flight>& flight, uint64_t subscriber);
+
+private:
+    Backend& _backend;
+    std::unordered_map<Key, std::shared_ptr<Flight>> _flights;
+};
+
+} // namespace lab1
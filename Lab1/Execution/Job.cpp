@@ -0,0 +1,169 @@
+#include <Lab1/Execution/Job.hpp>
+
+#include <cerrno>
+#include <string_view>
+#include <unistd.h>
+#include <utility>
+#include <variant>
+
+namespace lab1 {
+
+void Interrupt::raise() noexcept
+{
+    {
+        std::lock_guard lock{_mutex};
+        _raised = true;
+    }
+    _condition.notify_all();
+}
+
+void Interrupt::reset() noexcept
+{
+    std::lock_guard lock{_mutex};
+    _raised = false;
+}
+
+bool Interrupt::wait_for(const std::chrono::nanoseconds duration)
+{
+    std::unique_lock lock{_mutex};
+    return _condition.wait_for(lock, duration, [this] { return _raised; });
+}
+
+void Interrupt::wait()
+{
+    std::unique_lock lock{_mutex};
+    _condition.wait(lock, [this] { return _raised; });
+}
+
+auto pack(const Job& job) noexcept -> PackedJob
+{
+    return {
+        static_cast<uint8_t>(job.operation.index()),
+        static_cast<uint8_t>(job.function),
+        static_cast<uint32_t>(job.index),
+        static_cast<uint8_t>(job.origin.priority)
+    };
+}
+
+auto unpack(const PackedJob& packed) noexcept -> std::optional<Job>
+{
+    auto operation = from_index(packed.operation);
+    if (!operation) {
+        return {};
+    }
+
+    if (packed.function > static_cast<uint8_t>(Function::G)) {
+        return {};
+    }
+
+    if (packed.priority >= kPriorities) {
+        return {};
+    }
+
+    const bool in_range = std::visit(
+        [&] (const auto operation) {
+            return packed.index < decltype(operation)::kSize;
+        },
+        *operation
+    );
+    if (!in_range) {
+        return {};
+    }
+
+    Origin origin;
+    origin.priority = static_cast<Priority>(packed.priority);
+    return Job{std::move(*operation), static_cast<Function>(packed.function), packed.index, origin};
+}
+
+auto evaluate_value(const Job& job) -> int64_t
+{
+    return std::visit(
+        [&] (const auto operation) {
+            using Op = decltype(operation);
+
+            const auto value = job.function == Function::F
+                ? spos::lab1::demo::f_func<Op::kNativeOperation>(job.index)
+                : spos::lab1::demo::g_func<Op::kNativeOperation>(job.index);
+
+            return static_cast<int64_t>(value);
+        },
+        job.operation
+    );
+}
+
+auto serialize(const Operation& operation, const int64_t value) -> std::string
+{
+    return std::visit(
+        [&] (const auto operation) {
+            using Op = decltype(operation);
+            return std::string{Op::serialize(static_cast<typename Op::value_type>(value))};
+        },
+        operation
+    );
+}
+
+auto deserialize(const Operation& operation, const std::string_view serialized) -> std::optional<int64_t>
+{
+    return std::visit(
+        [&] (const auto operation) -> std::optional<int64_t> {
+            using Op = decltype(operation);
+            if (const auto value = Op::deserialize(serialized)) {
+                return static_cast<int64_t>(*value);
+            }
+            return {};
+        },
+        operation
+    );
+}
+
+auto evaluate(const Job& job) -> std::string
+{
+    return serialize(job.operation, evaluate_value(job));
+}
+
+auto evaluate(const Job& job, const int fd) -> bool
+{
+    const auto serialized = evaluate(job);
+    std::string_view remaining{serialized};
+    while (!remaining.empty()) {
+        const auto written = ::write(fd, remaining.data(), remaining.size());
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (written <= 0) {
+            return false;
+        }
+
+        remaining.remove_prefix(written);
+    }
+
+    return true;
+}
+
+auto evaluate(const Job& job, Interrupt& interrupt) -> std::optional<int64_t>
+{
+    return std::visit(
+        [&] (const auto operation) -> std::optional<int64_t> {
+            using Op = decltype(operation);
+
+            const auto& cases = spos::lab1::demo::op_group_traits<Op::kNativeOperation>::cases[job.index];
+            const auto& attributes = job.function == Function::F ? cases.f_attrs : cases.g_attrs;
+            if (!attributes) {
+                /// Function never finishes
+                interrupt.wait();
+                return {};
+            }
+
+            const auto& [duration, value] = *attributes;
+            if (interrupt.wait_for(duration)) {
+                return {};
+            }
+
+            return static_cast<int64_t>(value);
+        },
+        job.operation
+    );
+}
+
+} // namespace lab1
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <Lab1/Server/Operations.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace lab1 {
+
+/**
+ * @brief Predefined function to evaluate.
+ */
+enum class Function : uint8_t
+{
+    F,
+    G
+};
+
+/**
+ * @brief Class of a request, jobs of a more urgent class are
+ *  evaluated first.
+ */
+enum class Priority : uint8_t
+{
+    System,
+    Foreground,
+    Background
+};
+
+/**
+ * @brief Amount of priority classes.
+ */
+constexpr size_t kPriorities = static_cast<size_t>(Priority::Background) + 1;
+
+/**
+ * @brief Client job is evaluated for, so evaluations are shared
+ *  fairly between clients.
+ */
+struct Origin
+{
+    /**
+     * @brief Key of a client, usually derived from its address.
+     */
+    uint64_t client = 0;
+
+    /**
+     * @brief Session of a client.
+     */
+    uint64_t session = 0;
+
+    /**
+     * @brief Share of evaluations client is entitled to.
+     */
+    size_t weight = 1;
+
+    /**
+     * @brief Class of a request.
+     */
+    Priority priority = Priority::Foreground;
+};
+
+/**
+ * @brief Description of a single function evaluation.
+ */
+struct Job
+{
+    /**
+     * @brief Operation function belongs to.
+     */
+    Operation operation;
+
+    /**
+     * @brief Which of predefined functions to evaluate.
+     */
+    Function function;
+
+    /**
+     * @brief Index of predefined case.
+     */
+    size_t index;
+
+    /**
+     * @brief Client job is evaluated for.
+     */
+    Origin origin{};
+};
+
+/**
+ * @brief Flag allowing to interrupt evaluation running in another thread.
+ */
+class Interrupt
+{
+public:
+    /**
+     * @brief Interrupt evaluation, wake up waiting thread.
+     */
+    void raise() noexcept;
+
+    /**
+     * @brief Prepare for the next evaluation.
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief Wait for at most @a duration.
+     * @return Whether interrupt was raised.
+     */
+    [[nodiscard]]
+    bool wait_for(std::chrono::nanoseconds duration);
+
+    /**
+     * @brief Wait until interrupt is raised.
+     */
+    void wait();
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _raised = false;
+};
+
+/**
+ * @brief Compact representation of a job suitable for passing
+ *  between processes.
+ */
+struct PackedJob
+{
+    uint8_t operation;
+    uint8_t function;
+    uint32_t index;
+    uint8_t priority = static_cast<uint8_t>(Priority::Foreground);
+};
+
+/**
+ * @brief Pack @a job to be sent to another process.
+ */
+[[nodiscard]]
+auto pack(const Job& job) noexcept -> PackedJob;
+
+/**
+ * @brief Restore job received from another process.
+ * @return Empty optional if @a packed job is malformed.
+ */
+[[nodiscard]]
+auto unpack(const PackedJob& packed) noexcept -> std::optional<Job>;
+
+/**
+ * @brief Evaluate @a job in the calling thread.
+ * @return Raw value of result, see @a serialize.
+ * @note May block forever, depending on predefined case.
+ */
+[[nodiscard]]
+auto evaluate_value(const Job& job) -> int64_t;
+
+/**
+ * @brief Serialize raw @a value of a result of @a operation.
+ */
+[[nodiscard]]
+auto serialize(const Operation& operation, int64_t value) -> std::string;
+
+/**
+ * @brief Restore raw value of a result of @a operation from its
+ *  @a serialized form.
+ * @return Empty optional if result is malformed.
+ */
+[[nodiscard]]
+auto deserialize(const Operation& operation, std::string_view serialized) -> std::optional<int64_t>;
+
+/**
+ * @brief Evaluate @a job in the calling thread.
+ * @return Serialized result of evaluation.
+ * @note May block forever, depending on predefined case.
+ */
+[[nodiscard]]
+auto evaluate(const Job& job) -> std::string;
+
+/**
+ * @brief Evaluate @a job in the calling thread and write
+ *  serialized result to @a fd.
+ * @return Whether result was written successfully.
+ */
+[[nodiscard]]
+auto evaluate(const Job& job, int fd) -> bool;
+
+/**
+ * @brief Evaluate @a job in the calling thread unless @a interrupt is raised.
+ * @return Raw value of result or empty optional if interrupted.
+ * @note Predefined functions can't be interrupted, so their behaviour is
+ *  reproduced by waiting on @a interrupt instead of sleeping.
+ */
+[[nodiscard]]
+auto evaluate(const Job& job, Interrupt& interrupt) -> std::optional<int64_t>;
+
+} // namespace lab1
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <csignal>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace lab1::pidfd {
+
+/**
+ * @brief Obtain descriptor referring to process @a pid.
+ * @return Descriptor or -1 on failure with errno set.
+ * @note System calls are used directly since C library
+ *  wrappers aren't available everywhere.
+ */
+[[nodiscard]]
+inline auto open(const pid_t pid) noexcept -> int
+{
+    return static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+}
+
+/**
+ * @brief Send @a sig to process referred by @a fd.
+ */
+inline auto send_signal(const int fd, const int sig) noexcept -> int
+{
+    return static_cast<int>(::syscall(SYS_pidfd_send_signal, fd, sig, nullptr, 0));
+}
+
+/**
+ * @brief Collect status of finished child referred by @a fd
+ *  without blocking.
+ * @param info Filled with exit status, @c si_pid is 0 if child
+ *  hasn't finished yet.
+ * @param usage Filled with resources used by child.
+ * @return 0 on success or -1 on failure with errno set.
+ */
+inline auto wait(const int fd, siginfo_t& info, rusage& usage) noexcept -> int
+{
+    info.si_pid = 0;
+    return static_cast<int>(::syscall(SYS_waitid, P_PIDFD, fd, &info, WEXITED | WNOHANG, &usage));
+}
+
+} // namespace lab1::pidfd
@@ -0,0 +1,193 @@
+#include <Lab1/Execution/Placement.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace lab1 {
+namespace {
+
+    /**
+     * @brief Directory NUMA nodes are described in.
+     */
+    constexpr std::string_view kNodes = "/sys/devices/system/node/";
+
+    [[nodiscard]]
+    auto parse_core(const std::string_view str, const std::string_view list) -> int
+    {
+        int core = 0;
+        const auto [end, ec] = std::from_chars(str.begin(), str.end(), core);
+        if (ec != std::errc{} || end != str.end() || core < 0 || core >= CPU_SETSIZE) {
+            throw std::invalid_argument{"Malformed list of cores: " + std::string{list}};
+        }
+        return core;
+    }
+
+    /**
+     * @brief Read list of cores or nodes from @a path.
+     */
+    [[nodiscard]]
+    auto read_list(const std::string& path) -> std::optional<Cores>
+    {
+        std::ifstream file{path};
+        std::string list;
+        if (!std::getline(file, list)) {
+            return {};
+        }
+
+        try {
+            return parse_cores(list);
+        } catch (const std::invalid_argument&) {
+            return {};
+        }
+    }
+
+    /**
+     * @brief Cores of every online NUMA node in order of their numbers.
+     * @return Empty vector if nodes aren't known.
+     */
+    [[nodiscard]]
+    auto numa_nodes() -> std::vector<Cores>
+    {
+        /// Numbers of nodes may have gaps
+        const auto online = read_list(std::string{kNodes} + "online");
+        if (!online) {
+            return {};
+        }
+
+        std::vector<Cores> nodes;
+        for (const auto node : *online) {
+            auto cores = read_list(std::string{kNodes} + "node" + std::to_string(node) + "/cpulist");
+            if (!cores) {
+                return {};
+            }
+            nodes.push_back(std::move(*cores));
+        }
+        return nodes;
+    }
+
+} // namespace
+
+auto parse_cores(const std::string_view list) -> Cores
+{
+    Cores cores;
+    auto rest = list;
+    while (!rest.empty()) {
+        const auto comma = rest.find(',');
+        const auto range = rest.substr(0, comma);
+        rest.remove_prefix(comma == std::string_view::npos ? rest.size() : comma + 1);
+
+        const auto dash = range.find('-');
+        const auto first = parse_core(range.substr(0, dash), list);
+        const auto last = dash == std::string_view::npos ? first : parse_core(range.substr(dash + 1), list);
+        if (last < first) {
+            throw std::invalid_argument{"Malformed list of cores: " + std::string{list}};
+        }
+
+        for (auto core = first; core <= last; ++core) {
+            cores.push_back(core);
+        }
+    }
+
+    std::sort(cores.begin(), cores.end());
+    cores.erase(std::unique(cores.begin(), cores.end()), cores.end());
+    return cores;
+}
+
+auto allowed_cores() -> Cores
+{
+    Cores cores;
+    cpu_set_t set;
+    if (::sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int core = 0; core < CPU_SETSIZE; ++core) {
+            if (CPU_ISSET(core, &set)) {
+                cores.push_back(core);
+            }
+        }
+    }
+    return cores;
+}
+
+bool pin(const pid_t pid, const Cores& cores) noexcept
+{
+    if (cores.empty()) {
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const auto core : cores) {
+        CPU_SET(core, &set);
+    }
+    return ::sched_setaffinity(pid, sizeof(set), &set) == 0;
+}
+
+Placement::Placement(Cores loops, Cores children, const bool spread) :
+    _loops{std::move(loops)},
+    _children{std::move(children)}
+{
+    if (_loops.empty() && spread) {
+        _spread = allowed_cores();
+    }
+
+    if (_children.empty() && !_loops.empty()) {
+        const auto allowed = allowed_cores();
+        std::set_difference(
+            allowed.begin(),
+            allowed.end(),
+            _loops.begin(),
+            _loops.end(),
+            std::back_inserter(_children)
+        );
+    }
+
+    if (auto nodes = numa_nodes(); nodes.size() > 1) {
+        _nodes = std::move(nodes);
+    }
+}
+
+auto Placement::loop(const size_t loop) const noexcept -> std::optional<int>
+{
+    if (!_loops.empty()) {
+        return _loops[loop % _loops.size()];
+    }
+    if (!_spread.empty()) {
+        return _spread[loop % _spread.size()];
+    }
+    return {};
+}
+
+auto Placement::children(const size_t loop) const -> Cores
+{
+    const auto core = this->loop(loop);
+    if (!core) {
+        return _children;
+    }
+
+    /// Children stay on the node of their loop, if it has any of their cores
+    for (const auto& node : _nodes) {
+        if (!std::binary_search(node.begin(), node.end(), *core)) {
+            continue;
+        }
+
+        Cores local;
+        std::set_intersection(
+            _children.begin(),
+            _children.end(),
+            node.begin(),
+            node.end(),
+            std::back_inserter(local)
+        );
+        if (!local.empty()) {
+            return local;
+        }
+    }
+
+    return _children;
+}
+
+} // namespace lab1
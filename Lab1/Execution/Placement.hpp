@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <sched.h>
+#include <string_view>
+#include <sys/types.h>
+#include <vector>
+
+namespace lab1 {
+
+/**
+ * @brief Set of cores, ascending.
+ */
+using Cores = std::vector<int>;
+
+/**
+ * @brief Parse list of cores in the following format:
+ *  <core>[-<core>][,<core>[-<core>]...]
+ * @example
+ *  0-3,8,10-11
+ * @throw std::invalid_argument If list is malformed.
+ */
+[[nodiscard]]
+auto parse_cores(std::string_view list) -> Cores;
+
+/**
+ * @brief Cores process is allowed to run on.
+ */
+[[nodiscard]]
+auto allowed_cores() -> Cores;
+
+/**
+ * @brief Restrict process @a pid, the calling one if zero, to @a cores.
+ * @return Whether affinity is changed, nothing is done if @a cores
+ *  are empty.
+ */
+bool pin(pid_t pid, const Cores& cores) noexcept;
+
+/**
+ * @brief Cores event loops and children evaluating their jobs run on.
+ *
+ * Event loops take turns on their own cores, while children of a loop
+ * run on the rest of cores. Once machine has several NUMA nodes,
+ * children are kept on the node of the core their loop is pinned to,
+ * so memory of the loop stays local to them.
+ */
+class Placement
+{
+public:
+    /**
+     * @brief Nobody is pinned.
+     */
+    Placement() = default;
+
+    /**
+     * @param loops Cores reserved for event loops.
+     * @param children Cores of children, all allowed cores except
+     *  those of event loops if empty.
+     * @param spread Whether event loops are spread over allowed cores
+     *  unless cores are reserved for them.
+     */
+    Placement(Cores loops, Cores children, bool spread);
+
+    /**
+     * @brief Core event loop @a loop is pinned to, if any.
+     */
+    [[nodiscard]]
+    auto loop(size_t loop) const noexcept -> std::optional<int>;
+
+    /**
+     * @brief Cores children of event loop @a loop are restricted to,
+     *  empty if they aren't.
+     */
+    [[nodiscard]]
+    auto children(size_t loop) const -> Cores;
+
+private:
+    Cores _loops;
+    Cores _children;
+    /// Cores event loops are spread over, if none are reserved
+    Cores _spread;
+    /// Cores of every NUMA node, if there are several
+    std::vector<Cores> _nodes;
+};
+
+} // namespace lab1
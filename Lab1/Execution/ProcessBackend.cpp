@@ -0,0 +1,477 @@
+#include <Lab1/Execution/ProcessBackend.hpp>
+
+#include <Lab1/Execution/Pidfd.hpp>
+
+#include <algorithm>
+#include <array>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/system/error_code.hpp>
+#include <cerrno>
+#include <csignal>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <sys/wait.h>
+#include <sysexits.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace lab1 {
+namespace {
+
+    /// Results are a few bytes long, so they are read by small chunks
+    constexpr size_t kChunkSize = 64;
+
+} // namespace
+
+/**
+ * @brief State shared between task and pending operations.
+ */
+struct ProcessBackend::State
+{
+    State(boost::asio::io_context& context, const Job& job, Reaper* reaper, Results* results, Backend::Handler handler) :
+        operation{job.operation},
+        reaper{reaper},
+        results{results},
+        pipe{context},
+        process{context},
+        handler{std::move(handler)}
+    { }
+
+    ~State() noexcept
+    {
+        /// Child is collected, so nobody writes slot anymore
+        if (tag) {
+            results->release(*tag);
+        }
+
+        /// Ring doesn't wait for descriptors anymore
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        if (pidfd >= 0) {
+            ::close(pidfd);
+        }
+    }
+
+    /**
+     * @brief Descriptor of child process, -1 if it is collected by reaper.
+     */
+    [[nodiscard]]
+    int process_fd() noexcept
+    {
+        return process.is_open() ? process.native_handle() : pidfd;
+    }
+
+    /**
+     * @brief Invoke handler at most once.
+     */
+    void complete(const std::optional<int64_t> result)
+    {
+        if (!handler) {
+            return;
+        }
+
+        auto callback = std::move(handler);
+        handler = nullptr;
+        callback(result);
+    }
+
+    /**
+     * @brief Complete job once both result is read and child is collected.
+     */
+    void try_complete()
+    {
+        if (!read || !exited) {
+            return;
+        }
+
+        /// Only result read from pipe of its own is serialized
+        complete(succeeded && output ? deserialize(operation, *output) : std::nullopt);
+    }
+
+    /**
+     * @brief Complete job with raw @a value of its result, child
+     *  isn't waited for, since result is written as a whole.
+     */
+    void deliver(const int64_t value)
+    {
+        read = true;
+        complete(value);
+    }
+
+    /**
+     * @brief Deliver result once its slot of shared memory is written.
+     * @return Whether result is delivered.
+     */
+    bool take_slot()
+    {
+        if (read) {
+            return true;
+        }
+
+        if (results->channel() != Results::Channel::Memory) {
+            return false;
+        }
+
+        auto& written = results->slot(*tag);
+        if (written.ready.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+
+        deliver(written.value);
+        return true;
+    }
+
+    /**
+     * @brief Give up on result of finished child unless it is written.
+     */
+    void abandon()
+    {
+        if (!tag || take_slot()) {
+            return;
+        }
+
+        /// Record written by successful child is yet to be read from pipe
+        if (results->channel() == Results::Channel::Pipe && exited && succeeded) {
+            return;
+        }
+
+        read = true;
+    }
+
+    /**
+     * @brief Handle finished child.
+     */
+    void finish(const siginfo_t& info, const rusage& usage)
+    {
+        exited = true;
+        if (info.si_code != CLD_EXITED || info.si_status != EX_OK) {
+            succeeded = false;
+            if (handler) {
+                std::cerr << "Child " << pid
+                          << (info.si_code == CLD_EXITED ? " exited with code " : " was killed by signal ")
+                          << info.si_status
+                          << " after " << usage.ru_utime.tv_sec * 1000 + usage.ru_utime.tv_usec / 1000 << " ms user"
+                          << " and " << usage.ru_stime.tv_sec * 1000 + usage.ru_stime.tv_usec / 1000 << " ms system time"
+                          << ", max RSS " << usage.ru_maxrss << " KB"
+                          << std::endl;
+            }
+        }
+
+        /// Result may be written before it is noticed
+        abandon();
+        try_complete();
+    }
+
+    /**
+     * @brief Terminate child, it is collected once finished.
+     */
+    void terminate() noexcept
+    {
+        /// Close pipe, the one read by ring is closed once child is killed
+        boost::system::error_code ec;
+        pipe.close(ec);
+        if (const auto fd = process_fd(); fd >= 0) {
+            pidfd::send_signal(fd, SIGKILL);
+        } else if (reaper && pid > 0) {
+            reaper->kill(pid, SIGKILL);
+        }
+    }
+
+    /**
+     * @brief Collect child referred by process descriptor.
+     */
+    void collect()
+    {
+        siginfo_t info;
+        rusage usage;
+        if (pidfd::wait(process_fd(), info, usage) != 0 || info.si_pid == 0) {
+            /// Child is parented by someone else, nothing to collect
+            exited = true;
+            abandon();
+            try_complete();
+            return;
+        }
+
+        finish(info, usage);
+    }
+
+    Operation operation;
+    pid_t pid = -1;
+    Reaper* reaper;
+    Results* results;
+    /// Tag of a slot result is written to, otherwise it is read from pipe
+    std::optional<uint64_t> tag;
+    boost::asio::posix::stream_descriptor pipe;
+    boost::asio::posix::stream_descriptor process;
+    /// Pipe and process descriptor waited for by ring, they aren't
+    /// registered with reactor, so they are owned directly
+    int fd = -1;
+    int pidfd = -1;
+    std::string buffer;
+    Backend::Handler handler;
+    std::optional<std::string> output;
+    bool read = false;
+    bool exited = false;
+    bool succeeded = true;
+};
+
+/**
+ * @brief Job evaluated by a child process.
+ */
+class ProcessBackend::ProcessTask final: public Backend::Task
+{
+public:
+    explicit ProcessTask(std::shared_ptr<State> state) noexcept :
+        _state{std::move(state)}
+    { }
+
+    ~ProcessTask() noexcept override
+    {
+        /// Prevent handler from being called
+        _state->handler = nullptr;
+        _state->terminate();
+    }
+
+private:
+    std::shared_ptr<State> _state;
+};
+
+ProcessBackend::ProcessBackend(boost::asio::io_context& context,
+                               Spawner& spawner,
+                               Reaper* const reaper,
+                               Results* const results,
+                               Ring* const ring) :
+    _context{context},
+    _spawner{spawner},
+    _reaper{reaper},
+    _results{results},
+    _ring{ring},
+    _event{context}
+{
+    if (_results) {
+        const auto event = ::dup(_results->reader());
+        if (event < 0) {
+            throw std::system_error{errno, std::system_category(), "Can't duplicate eventfd of results"};
+        }
+        _event.assign(event);
+        _wait();
+    }
+}
+
+auto ProcessBackend::submit(const Job& job, Handler handler) -> std::unique_ptr<Task>
+{
+    auto state = std::make_shared<State>(_context, job, _reaper, _results, std::move(handler));
+    /// Result is read from pipe of its own once every slot is in use
+    state->tag = _results ? _results->acquire() : std::nullopt;
+    const Destination destination{_results, state->tag.value_or(0)};
+    /// Child may be created once task is canceled already
+    _spawner.async_spawn(
+        job,
+        state->tag ? &destination : nullptr,
+        [this, state] (const std::optional<Child> child) {
+            _start(state, child);
+        }
+    );
+
+    return std::make_unique<ProcessTask>(std::move(state));
+}
+
+void ProcessBackend::_start(const std::shared_ptr<State>& state, const std::optional<Child>& child)
+{
+    /// Children parented by the server are collected by reaper if there is one
+    const bool reaped = child && child->pidfd < 0 && _reaper;
+    const auto pidfd = !child || reaped ? -1 : child->pidfd >= 0 ? child->pidfd : pidfd::open(child->pid);
+    if (!child || (!reaped && pidfd < 0)) {
+        if (child) {
+            /// Child can't be tracked, get rid of it
+            if (child->fd >= 0) {
+                ::close(child->fd);
+            }
+            ::kill(child->pid, SIGKILL);
+            ::waitpid(child->pid, nullptr, 0);
+        }
+
+        /// Report failure asynchronously as any other result
+        boost::asio::post(_context, [state] { state->complete({}); });
+        return;
+    }
+
+    state->pid = child->pid;
+    if (state->tag) {
+        /// Result is delivered once it is written
+        _pending[Results::index(*state->tag)] = state;
+    } else if (_ring) {
+        state->fd = child->fd;
+        _read(state);
+    } else {
+        state->pipe.assign(child->fd);
+
+        /// Read result until child closes its end of a pipe
+        boost::asio::async_read(
+            state->pipe,
+            boost::asio::dynamic_buffer(state->buffer),
+            [state] (const auto ec, const auto) {
+                state->read = true;
+                if (ec == boost::asio::error::eof) {
+                    state->output = std::move(state->buffer);
+                }
+                state->try_complete();
+            }
+        );
+    }
+
+    if (reaped) {
+        /// Reaper may run on another event loop
+        _reaper->watch(
+            child->pid,
+            [this, state] (const siginfo_t& info, const rusage& usage) {
+                boost::asio::post(_context, [state, info, usage] {
+                    state->finish(info, usage);
+                });
+            }
+        );
+    } else if (_ring) {
+        /// Process descriptor becomes readable once child is finished
+        state->pidfd = pidfd;
+        _ring->poll(
+            pidfd,
+            [state] (const int result) {
+                if (result >= 0) {
+                    state->collect();
+                }
+            }
+        );
+    } else {
+        /// Process descriptor becomes readable once child is finished
+        state->process.assign(pidfd);
+        state->process.async_wait(
+            boost::asio::posix::stream_descriptor::wait_read,
+            [state] (const auto ec) {
+                if (!ec) {
+                    state->collect();
+                }
+            }
+        );
+    }
+
+    if (!state->handler) {
+        /// Task is canceled while child was being created
+        state->terminate();
+    }
+}
+
+void ProcessBackend::_wait()
+{
+    const auto deliver = [this] {
+        if (_results->channel() == Results::Channel::Pipe) {
+            _receive();
+        } else {
+            _collect();
+        }
+        _wait();
+    };
+
+    if (_ring) {
+        _ring->poll(
+            _event.native_handle(),
+            [deliver] (const int result) {
+                if (result >= 0) {
+                    deliver();
+                }
+            }
+        );
+        return;
+    }
+
+    _event.async_wait(
+        boost::asio::posix::stream_descriptor::wait_read,
+        [deliver] (const auto ec) {
+            if (!ec) {
+                deliver();
+            }
+        }
+    );
+}
+
+void ProcessBackend::_collect()
+{
+    /// Reset counter before slots are checked, so no signal is lost
+    uint64_t counter;
+    while (::read(_event.native_handle(), &counter, sizeof(counter)) < 0 && errno == EINTR) { }
+
+    for (auto pending = _pending.begin(); pending != _pending.end();) {
+        const auto state = pending->second.lock();
+        if (!state || state->take_slot()) {
+            pending = _pending.erase(pending);
+        } else {
+            ++pending;
+        }
+    }
+}
+
+void ProcessBackend::_receive()
+{
+    /// Records are written atomically, so they are never read partially
+    std::array<ResultRecord, 64> records;
+    while (true) {
+        const auto received = ::read(_event.native_handle(), records.data(), sizeof(records));
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (received <= 0) {
+            return;
+        }
+
+        for (size_t i = 0; i < static_cast<size_t>(received) / sizeof(ResultRecord); ++i) {
+            const auto& record = records[i];
+            const auto pending = _pending.find(Results::index(record.tag));
+            if (pending == _pending.end()) {
+                continue;
+            }
+
+            /// Record of a child whose slot is reused meanwhile is dropped
+            const auto state = pending->second.lock();
+            if (state && state->tag != record.tag) {
+                continue;
+            }
+
+            _pending.erase(pending);
+            if (state && !state->read) {
+                state->deliver(record.value);
+                state->try_complete();
+            }
+        }
+    }
+}
+
+void ProcessBackend::_read(const std::shared_ptr<State>& state)
+{
+    const auto size = state->buffer.size();
+    state->buffer.resize(size + kChunkSize);
+    _ring->read(
+        state->fd,
+        state->buffer.data() + size,
+        kChunkSize,
+        [this, state, size] (const int result) {
+            state->buffer.resize(size + std::max(result, 0));
+            if (result > 0) {
+                _read(state);
+                return;
+            }
+
+            state->read = true;
+            if (result == 0) {
+                state->output = std::move(state->buffer);
+            }
+            state->try_complete();
+        }
+    );
+}
+
+} // namespace lab1
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <Lab1/Execution/Backend.hpp>
+#include <Lab1/Execution/Reaper.hpp>
+#include <Lab1/Execution/Results.hpp>
+#include <Lab1/Execution/Ring.hpp>
+#include <Lab1/Execution/Spawner.hpp>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+namespace lab1 {
+
+/**
+ * @brief Backend evaluating every job in a dedicated child process.
+ *
+ * Children write raw values of results to results of the loop, either
+ * to slots of shared memory signalling eventfd or to a single pipe,
+ * so no pipe is created per child and job is finished as soon as its
+ * result is written. Result is read from a pipe of its own once every
+ * slot is in use. Pipes and children may be waited for by a ring
+ * instead of reactor.
+ */
+class ProcessBackend final: public Backend
+{
+public:
+    /**
+     * @param context Event loop to read results from.
+     * @param spawner Strategy of creating child processes.
+     * @param reaper Collector of children, if not provided every child
+     *  is tracked by its own process descriptor.
+     * @param results Slots children write results to, results are read
+     *  from pipes if not provided.
+     * @param ring Ring pipes and process descriptors are waited for by,
+     *  reactor is used otherwise.
+     */
+    ProcessBackend(boost::asio::io_context& context,
+                   Spawner& spawner,
+                   Reaper* reaper = nullptr,
+                   Results* results = nullptr,
+                   Ring* ring = nullptr);
+
+    [[nodiscard]]
+    auto submit(const Job& job, Handler handler) -> std::unique_ptr<Task> override;
+
+private:
+    struct State;
+    class ProcessTask;
+
+    /**
+     * @brief Wait for result and exit of @a child once it is created.
+     */
+    void _start(const std::shared_ptr<State>& state, const std::optional<Child>& child);
+
+    /**
+     * @brief Wait until any child writes its result.
+     */
+    void _wait();
+
+    /**
+     * @brief Deliver results of written slots.
+     */
+    void _collect();
+
+    /**
+     * @brief Deliver results of records read from pipe.
+     */
+    void _receive();
+
+    /**
+     * @brief Read result of job from its pipe by ring until child
+     *  closes its end.
+     */
+    void _read(const std::shared_ptr<State>& state);
+
+private:
+    boost::asio::io_context& _context;
+    Spawner& _spawner;
+    Reaper* _reaper;
+    Results* _results;
+    Ring* _ring;
+    /// Duplicate of descriptor of results owned by event loop
+    boost::asio::posix::stream_descriptor _event;
+    /// Jobs whose results are yet to be written by indices of their slots
+    std::unordered_map<uint32_t, std::weak_ptr<State>> _pending;
+};
+
+} // namespace lab1
@@ -0,0 +1,163 @@
+#include <Lab1/Execution/Profile.hpp>
+
+#include <charconv>
+#include <sched.h>
+#include <stdexcept>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace lab1 {
+namespace {
+
+    /**
+     * @brief Target of ioprio_set, not exposed by libc.
+     */
+    constexpr int kIoprioWhoProcess = 1;
+
+    /**
+     * @brief Offset of class in I/O priority value.
+     */
+    constexpr int kIoprioClassShift = 13;
+
+    template<typename T>
+    [[nodiscard]]
+    auto parse_number(const std::string_view str, const std::string_view rule) -> T
+    {
+        T value{};
+        const auto [end, ec] = std::from_chars(str.begin(), str.end(), value);
+        if (ec != std::errc{} || end != str.end()) {
+            throw std::invalid_argument{"Malformed profile rule: " + std::string{rule}};
+        }
+        return value;
+    }
+
+    [[nodiscard]]
+    auto parse_class(const std::string_view str, const std::string_view rule) -> Priority
+    {
+        if (str == "system") {
+            return Priority::System;
+        }
+        if (str == "foreground") {
+            return Priority::Foreground;
+        }
+        if (str == "background") {
+            return Priority::Background;
+        }
+        throw std::invalid_argument{"Unknown priority class in profile rule: " + std::string{rule}};
+    }
+
+    /**
+     * @brief Set single @a attribute of @a profile.
+     */
+    void set(Profile& profile,
+             const std::string_view attribute,
+             const std::string_view value,
+             const std::string_view rule)
+    {
+        if (attribute == "nice") {
+            const auto nice = parse_number<int>(value, rule);
+            if (nice < -20 || nice > 19) {
+                throw std::invalid_argument{"Nice value out of range: " + std::string{rule}};
+            }
+            profile.nice = nice;
+        } else if (attribute == "policy") {
+            if (value == "other") {
+                profile.policy = SCHED_OTHER;
+            } else if (value == "batch") {
+                profile.policy = SCHED_BATCH;
+            } else if (value == "idle") {
+                profile.policy = SCHED_IDLE;
+            } else {
+                throw std::invalid_argument{"Unknown policy in profile rule: " + std::string{rule}};
+            }
+        } else if (attribute == "io") {
+            if (value == "realtime") {
+                profile.io = Profile::Io::Realtime;
+            } else if (value == "best-effort") {
+                profile.io = Profile::Io::BestEffort;
+            } else if (value == "idle") {
+                profile.io = Profile::Io::Idle;
+            } else {
+                throw std::invalid_argument{"Unknown I/O class in profile rule: " + std::string{rule}};
+            }
+        } else if (attribute == "cpu") {
+            profile.cpu = parse_number<rlim_t>(value, rule);
+        } else if (attribute == "memory") {
+            profile.memory = parse_number<rlim_t>(value, rule);
+        } else {
+            throw std::invalid_argument{"Unknown attribute in profile rule: " + std::string{rule}};
+        }
+    }
+
+} // namespace
+
+bool apply(const Profile& profile, const pid_t pid) noexcept
+{
+    bool applied = true;
+    if (profile.policy) {
+        const sched_param parameters{};
+        applied &= ::sched_setscheduler(pid, *profile.policy, &parameters) == 0;
+    }
+
+    /// Nice value is kept by SCHED_BATCH and is ignored by SCHED_IDLE
+    if (profile.nice) {
+        applied &= ::setpriority(PRIO_PROCESS, static_cast<id_t>(pid), *profile.nice) == 0;
+    }
+
+    if (profile.io) {
+        const auto value = static_cast<int>(*profile.io) << kIoprioClassShift;
+        applied &= ::syscall(SYS_ioprio_set, kIoprioWhoProcess, pid, value) == 0;
+    }
+
+    if (profile.cpu != RLIM_INFINITY) {
+        const rlimit limit{profile.cpu, profile.cpu};
+        applied &= ::prlimit(pid, RLIMIT_CPU, &limit, nullptr) == 0;
+    }
+
+    if (profile.memory != RLIM_INFINITY) {
+        const rlimit limit{profile.memory, profile.memory};
+        applied &= ::prlimit(pid, RLIMIT_AS, &limit, nullptr) == 0;
+    }
+
+    return applied;
+}
+
+Profiles::Profiles() noexcept
+{
+    auto& background = _profiles[static_cast<size_t>(Priority::Background)];
+    background.policy = SCHED_IDLE;
+    background.nice = 19;
+    background.io = Profile::Io::Idle;
+}
+
+void Profiles::add(const std::string_view rule)
+{
+    const auto equals = rule.find('=');
+    if (equals == std::string_view::npos) {
+        throw std::invalid_argument{"Malformed profile rule: " + std::string{rule}};
+    }
+
+    Profile profile;
+    auto attributes = rule.substr(equals + 1);
+    while (!attributes.empty()) {
+        const auto comma = attributes.find(',');
+        const auto attribute = attributes.substr(0, comma);
+        attributes.remove_prefix(comma == std::string_view::npos ? attributes.size() : comma + 1);
+
+        const auto colon = attribute.find(':');
+        if (colon == std::string_view::npos) {
+            throw std::invalid_argument{"Malformed profile rule: " + std::string{rule}};
+        }
+        set(profile, attribute.substr(0, colon), attribute.substr(colon + 1), rule);
+    }
+
+    _profiles[static_cast<size_t>(parse_class(rule.substr(0, equals), rule))] = profile;
+}
+
+auto Profiles::get(const Priority priority) const noexcept -> const Profile&
+{
+    return _profiles[static_cast<size_t>(priority)];
+}
+
+} // namespace lab1
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Lab1/Execution/Job.hpp>
+
+#include <array>
+#include <optional>
+#include <string_view>
+#include <sys/resource.h>
+#include <sys/types.h>
+
+namespace lab1 {
+
+/**
+ * @brief Scheduling attributes child process evaluates its job with.
+ */
+struct Profile
+{
+    /**
+     * @brief Class of I/O scheduling.
+     */
+    enum class Io
+    {
+        Realtime = 1,
+        BestEffort,
+        Idle
+    };
+
+    /**
+     * @brief Nice value, unchanged if empty.
+     */
+    std::optional<int> nice;
+
+    /**
+     * @brief One of SCHED_OTHER, SCHED_BATCH, SCHED_IDLE, unchanged
+     *  if empty.
+     */
+    std::optional<int> policy;
+
+    /**
+     * @brief Class of I/O scheduling, unchanged if empty.
+     */
+    std::optional<Io> io;
+
+    /**
+     * @brief Limit of CPU time in seconds, child is killed once it is exceeded.
+     */
+    rlim_t cpu = RLIM_INFINITY;
+
+    /**
+     * @brief Limit of address space in bytes.
+     */
+    rlim_t memory = RLIM_INFINITY;
+};
+
+/**
+ * @brief Apply @a profile to process @a pid, the calling one if zero.
+ * @return Whether every attribute is applied.
+ * @note Async-signal-safe, so it can be called by a child of
+ *  a multithreaded process.
+ */
+bool apply(const Profile& profile, pid_t pid = 0) noexcept;
+
+/**
+ * @brief Profiles of children by priority class of their requests.
+ */
+class Profiles
+{
+public:
+    /**
+     * @brief Background jobs run at the lowest priority of both CPU and
+     *  I/O, others are left as they are.
+     */
+    Profiles() noexcept;
+
+    /**
+     * @brief Replace profile of a class by rule in the following format:
+     *  <class>=<attribute>:<value>[,<attribute>:<value>...]
+     *  where attribute is one of nice, policy (other, batch, idle),
+     *  io (realtime, best-effort, idle), cpu (seconds), memory (bytes).
+     * @example
+     *  background=nice:19,policy:batch,cpu:30
+     * @throw std::invalid_argument If rule is malformed.
+     */
+    void add(std::string_view rule);
+
+    /**
+     * @brief Profile of jobs of @a priority class.
+     */
+    [[nodiscard]]
+    auto get(Priority priority) const noexcept -> const Profile&;
+
+private:
+    std::array<Profile, kPriorities> _profiles;
+};
+
+} // namespace lab1
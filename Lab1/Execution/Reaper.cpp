@@ -0,0 +1,94 @@
+#include <Lab1/Execution/Reaper.hpp>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/system/error_code.hpp>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <utility>
+
+namespace lab1 {
+
+Reaper::Reaper(boost::asio::io_context& context) :
+    _context{context},
+    _signals{_context, SIGCHLD}
+{ }
+
+void Reaper::start()
+{
+    boost::asio::co_spawn(_context, _run(), boost::asio::detached);
+}
+
+void Reaper::stop()
+{
+    boost::system::error_code ec;
+    _signals.cancel(ec);
+}
+
+void Reaper::watch(const pid_t pid, Handler handler)
+{
+    std::unique_lock lock{_mutex};
+    if (const auto collected = _collected.find(pid); collected != _collected.end()) {
+        const auto [info, usage] = collected->second;
+        _collected.erase(collected);
+        lock.unlock();
+        handler(info, usage);
+        return;
+    }
+
+    _watched.insert_or_assign(pid, std::move(handler));
+}
+
+bool Reaper::kill(const pid_t pid, const int signal) noexcept
+{
+    std::lock_guard lock{_mutex};
+    return _watched.count(pid) != 0 && ::kill(pid, signal) == 0;
+}
+
+auto Reaper::_run() -> boost::asio::awaitable<void>
+{
+    boost::system::error_code ec;
+    while (true) {
+        /// Children finished before signal handler was installed are collected too
+        _drain();
+
+        co_await _signals.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+        if (ec) {
+            co_return;
+        }
+    }
+}
+
+void Reaper::_drain()
+{
+    /// Signals are coalesced, so collect everyone who has finished
+    while (true) {
+        siginfo_t info;
+        info.si_pid = 0;
+        rusage usage;
+        /// System call is used directly to obtain resources usage
+        if (::syscall(SYS_waitid, P_ALL, 0, &info, WEXITED | WNOHANG, &usage) != 0 || info.si_pid == 0) {
+            return;
+        }
+
+        std::unique_lock lock{_mutex};
+        const auto watched = _watched.find(info.si_pid);
+        if (watched == _watched.end()) {
+            /// Child may be created by another thread, which hasn't watched it yet
+            _collected.insert_or_assign(info.si_pid, std::pair{info, usage});
+            continue;
+        }
+
+        auto handler = std::move(watched->second);
+        _watched.erase(watched);
+        lock.unlock();
+        if (handler) {
+            handler(info, usage);
+        }
+    }
+}
+
+} // namespace lab1
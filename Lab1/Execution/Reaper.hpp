@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Lab1/Execution/Awaitable.hpp>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <csignal>
+#include <functional>
+#include <mutex>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <unordered_map>
+#include <utility>
+
+namespace lab1 {
+
+/**
+ * @brief Single collector of all finished children of the server.
+ *
+ * Waits for @c SIGCHLD and collects every finished child at once,
+ * notifying whoever is watching it. Children may be watched from any
+ * thread, handlers are invoked from event loop of the reaper.
+ */
+class Reaper
+{
+public:
+    /**
+     * @brief Callback receiving exit status and resource usage of a child.
+     */
+    using Handler = std::function<void(const siginfo_t&, const rusage&)>;
+
+    /**
+     * @param context Event loop to listen to signals on.
+     */
+    explicit Reaper(boost::asio::io_context& context);
+
+    /**
+     * @brief Start collecting children.
+     */
+    void start();
+
+    /**
+     * @brief Stop listening to signals.
+     */
+    void stop();
+
+    /**
+     * @brief Notify @a handler once child @a pid is collected.
+     * @note Handler is invoked immediately if child was collected
+     *  before it was watched.
+     */
+    void watch(pid_t pid, Handler handler);
+
+    /**
+     * @brief Send @a signal to child @a pid unless it is collected already,
+     *  so pid can't be reused by someone else meanwhile.
+     * @return Whether signal was sent.
+     */
+    bool kill(pid_t pid, int signal) noexcept;
+
+private:
+    /**
+     * @brief Collect children every time signal arrives.
+     */
+    auto _run() -> boost::asio::awaitable<void>;
+
+    void _drain();
+
+private:
+    boost::asio::io_context& _context;
+    boost::asio::signal_set _signals;
+    std::mutex _mutex;
+    std::unordered_map<pid_t, Handler> _watched;
+    /// Collected before anybody has watched them
+    std::unordered_map<pid_t, std::pair<siginfo_t, rusage>> _collected;
+};
+
+} // namespace lab1
@@ -0,0 +1,197 @@
+#include <Lab1/Execution/Results.hpp>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <new>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace lab1 {
+namespace {
+
+    /**
+     * @brief Write whole @a size bytes of @a data at once.
+     */
+    [[nodiscard]]
+    bool write_whole(const int fd, const void* const data, const size_t size) noexcept
+    {
+        ssize_t written;
+        while ((written = ::write(fd, data, size)) < 0 && errno == EINTR) { }
+        return written == static_cast<ssize_t>(size);
+    }
+
+    /**
+     * @brief Write @a value to @a slot and signal @a event.
+     */
+    [[nodiscard]]
+    bool publish_slot(ResultSlot& slot, const int event, const int64_t value) noexcept
+    {
+        slot.value = value;
+        slot.ready.store(1, std::memory_order_release);
+
+        const uint64_t increment = 1;
+        return write_whole(event, &increment, sizeof(increment));
+    }
+
+    /**
+     * @brief Write @a value tagged with @a tag to @a pipe.
+     */
+    [[nodiscard]]
+    bool publish_record(const int pipe, const uint64_t tag, const int64_t value) noexcept
+    {
+        const ResultRecord record{tag, value};
+        return write_whole(pipe, &record, sizeof(record));
+    }
+
+} // namespace
+
+Results::Results(const size_t capacity, const Channel channel) :
+    _channel{channel},
+    _capacity{capacity},
+    _generations(capacity)
+{
+    if (_channel == Channel::Pipe) {
+        int fds[2];
+        if (::pipe2(fds, O_CLOEXEC) != 0) {
+            throw std::system_error{errno, std::system_category(), "Can't create pipe of results"};
+        }
+
+        /// Children may block on a full pipe, event loop mustn't
+        ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+        _reader = fds[0];
+        _event = fds[1];
+    } else {
+        _memory = ::memfd_create("lab1-results", MFD_CLOEXEC);
+        if (_memory < 0) {
+            throw std::system_error{errno, std::system_category(), "Can't create memory of results"};
+        }
+
+        const auto size = sizeof(ResultSlot) * capacity;
+        void* mapped = MAP_FAILED;
+        if (::ftruncate(_memory, static_cast<off_t>(size)) == 0) {
+            mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _memory, 0);
+        }
+        if (mapped == MAP_FAILED) {
+            const auto error = errno;
+            ::close(_memory);
+            throw std::system_error{error, std::system_category(), "Can't map memory of results"};
+        }
+
+        _event = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (_event < 0) {
+            const auto error = errno;
+            ::munmap(mapped, size);
+            ::close(_memory);
+            throw std::system_error{error, std::system_category(), "Can't create eventfd of results"};
+        }
+
+        _reader = _event;
+        _slots = static_cast<ResultSlot*>(mapped);
+        for (size_t i = 0; i < capacity; ++i) {
+            new (&_slots[i]) ResultSlot{};
+        }
+    }
+
+    _free.reserve(capacity);
+    for (size_t i = capacity; i > 0; --i) {
+        _free.push_back(static_cast<uint32_t>(i - 1));
+    }
+}
+
+Results::~Results() noexcept
+{
+    if (_slots) {
+        ::munmap(_slots, sizeof(ResultSlot) * _capacity);
+    }
+    if (_reader != _event) {
+        ::close(_reader);
+    }
+    ::close(_event);
+    if (_memory >= 0) {
+        ::close(_memory);
+    }
+}
+
+auto Results::acquire() noexcept -> std::optional<uint64_t>
+{
+    if (_free.empty()) {
+        return {};
+    }
+
+    const auto index = _free.back();
+    _free.pop_back();
+    if (_slots) {
+        _slots[index].ready.store(0, std::memory_order_relaxed);
+    }
+    return static_cast<uint64_t>(++_generations[index]) << 32 | index;
+}
+
+void Results::release(const uint64_t tag) noexcept
+{
+    _free.push_back(index(tag));
+}
+
+auto Results::slot(const uint64_t tag) noexcept -> ResultSlot&
+{
+    return _slots[index(tag)];
+}
+
+bool Results::publish(const uint64_t tag, const int64_t value) noexcept
+{
+    if (_slots) {
+        return publish_slot(slot(tag), _event, value);
+    }
+    return publish_record(_event, tag, value);
+}
+
+auto Results::capacity() const noexcept -> size_t
+{
+    return _capacity;
+}
+
+auto Results::channel() const noexcept -> Channel
+{
+    return _channel;
+}
+
+int Results::memory() const noexcept
+{
+    return _memory;
+}
+
+int Results::event() const noexcept
+{
+    return _event;
+}
+
+int Results::reader() const noexcept
+{
+    return _reader;
+}
+
+bool publish(const int memory, const int event, const uint64_t tag, const int64_t value) noexcept
+{
+    if (memory < 0) {
+        return publish_record(event, tag, value);
+    }
+
+    struct stat status;
+    const auto index = Results::index(tag);
+    if (::fstat(memory, &status) != 0 || (static_cast<size_t>(index) + 1) * sizeof(ResultSlot) > static_cast<size_t>(status.st_size)) {
+        return false;
+    }
+
+    void* mapped = ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, memory, 0);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    const auto published = publish_slot(static_cast<ResultSlot*>(mapped)[index], event, value);
+    ::munmap(mapped, static_cast<size_t>(status.st_size));
+    return published;
+}
+
+} // namespace lab1
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace lab1 {
+
+/**
+ * @brief Place a child writes raw value of its result to.
+ */
+struct alignas(64) ResultSlot
+{
+    /**
+     * @brief Set once value is written.
+     */
+    std::atomic<uint32_t> ready;
+
+    /**
+     * @brief Raw value of result.
+     */
+    int64_t value;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+/**
+ * @brief Result written by a child to a pipe shared with others.
+ */
+struct ResultRecord
+{
+    /**
+     * @brief Tag of a slot result belongs to.
+     */
+    uint64_t tag;
+
+    /**
+     * @brief Raw value of result.
+     */
+    int64_t value;
+};
+
+/// Records written by different children are never interleaved
+static_assert(sizeof(ResultRecord) <= PIPE_BUF);
+
+/**
+ * @brief Results children of an event loop write, along with a single
+ *  descriptor event loop waits on.
+ *
+ * Every child is given a slot tagged with its generation, so result of
+ * a child whose slot has been reused is told apart. Results are either
+ * written to memory shared with children and signalled by an eventfd,
+ * or written as fixed-size records to a single pipe. Memory is backed
+ * by a memfd, so children which don't inherit the mapping, such as
+ * those executing worker, map it by descriptor. Slots are acquired and
+ * released by a single event loop.
+ */
+class Results
+{
+public:
+    /**
+     * @brief Way results are delivered.
+     */
+    enum class Channel
+    {
+        /// Slots of shared memory signalled by eventfd
+        Memory,
+        /// Records written to a pipe
+        Pipe
+    };
+
+    /**
+     * @param capacity Amount of slots.
+     * @param channel Way results are delivered.
+     * @throw std::system_error If memory, eventfd or pipe can't be created.
+     */
+    explicit Results(size_t capacity, Channel channel = Channel::Memory);
+
+    Results(const Results&) = delete;
+    Results& operator=(const Results&) = delete;
+
+    ~Results() noexcept;
+
+    /**
+     * @brief Take free slot and clear it.
+     * @return Tag of the slot or empty optional if every slot is in use.
+     */
+    [[nodiscard]]
+    auto acquire() noexcept -> std::optional<uint64_t>;
+
+    /**
+     * @brief Return slot of @a tag to free ones.
+     */
+    void release(uint64_t tag) noexcept;
+
+    /**
+     * @brief Index of a slot of @a tag.
+     */
+    [[nodiscard]]
+    static constexpr auto index(const uint64_t tag) noexcept -> uint32_t
+    {
+        return static_cast<uint32_t>(tag);
+    }
+
+    /**
+     * @brief Slot of shared memory of @a tag.
+     * @note Memory channel only.
+     */
+    [[nodiscard]]
+    auto slot(uint64_t tag) noexcept -> ResultSlot&;
+
+    /**
+     * @brief Write @a value of a result tagged with @a tag and signal
+     *  event loop.
+     * @return Whether result is written.
+     * @note Async-signal-safe, so it can be called by a child.
+     */
+    bool publish(uint64_t tag, int64_t value) noexcept;
+
+    /**
+     * @brief Amount of slots.
+     */
+    [[nodiscard]]
+    auto capacity() const noexcept -> size_t;
+
+    [[nodiscard]]
+    auto channel() const noexcept -> Channel;
+
+    /**
+     * @brief Descriptor of shared memory, -1 for pipe channel.
+     */
+    [[nodiscard]]
+    int memory() const noexcept;
+
+    /**
+     * @brief Descriptor children signal eventfd or write records to.
+     */
+    [[nodiscard]]
+    int event() const noexcept;
+
+    /**
+     * @brief Descriptor event loop waits on.
+     */
+    [[nodiscard]]
+    int reader() const noexcept;
+
+private:
+    Channel _channel;
+    int _memory = -1;
+    int _event = -1;
+    int _reader = -1;
+    ResultSlot* _slots = nullptr;
+    size_t _capacity;
+    std::vector<uint32_t> _free;
+    std::vector<uint32_t> _generations;
+};
+
+/**
+ * @brief Write @a value of a result tagged with @a tag to slot of shared
+ *  memory referred by @a memory descriptor and signal @a event, or write
+ *  it as a record to @a event pipe if @a memory is negative.
+ * @return Whether result is written.
+ */
+bool publish(int memory, int event, uint64_t tag, int64_t value) noexcept;
+
+} // namespace lab1
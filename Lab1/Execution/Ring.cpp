@@ -0,0 +1,542 @@
+#include <Lab1/Execution/Ring.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <boost/asio/post.hpp>
+#include <boost/system/error_code.hpp>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace lab1 {
+namespace {
+
+    /// Operation whose completion is ignored, identifiers of others are never zero
+    constexpr Ring::Id kIgnored = 0;
+
+    /// Group of registered buffers reads select from
+    constexpr uint16_t kBufferGroup = 0;
+
+    /// Maximal amount of buffers in a group
+    constexpr size_t kMaxBuffers = 1 << 15;
+
+    /**
+     * @note System calls are used directly since liburing
+     *  isn't available everywhere.
+     */
+    [[nodiscard]]
+    auto setup(const unsigned entries, io_uring_params& params) noexcept -> int
+    {
+        return static_cast<int>(::syscall(SYS_io_uring_setup, entries, &params));
+    }
+
+    [[nodiscard]]
+    auto enter(const int fd, const unsigned submit, const unsigned flags) noexcept -> int
+    {
+        return static_cast<int>(::syscall(SYS_io_uring_enter, fd, submit, 0, flags, nullptr, 0));
+    }
+
+    [[nodiscard]]
+    auto register_ring(const int fd, const unsigned opcode, void* const argument, const unsigned count) noexcept -> int
+    {
+        return static_cast<int>(::syscall(SYS_io_uring_register, fd, opcode, argument, count));
+    }
+
+    /**
+     * @brief Map @a size bytes of memory shared with kernel.
+     */
+    [[nodiscard]]
+    void* map(const int fd, const size_t size, const off_t offset) noexcept
+    {
+        const auto flags = fd < 0 ? MAP_PRIVATE | MAP_ANONYMOUS : MAP_SHARED | MAP_POPULATE;
+        const auto address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, offset);
+        return address == MAP_FAILED ? nullptr : address;
+    }
+
+    template<typename T>
+    [[nodiscard]]
+    T* at(void* const base, const uint32_t offset) noexcept
+    {
+        return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+    }
+
+    /**
+     * @brief Read index of a ring written by kernel.
+     */
+    template<typename T>
+    [[nodiscard]]
+    T load(T* const index) noexcept
+    {
+        return std::atomic_ref<T>{*index}.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Publish index of a ring read by kernel.
+     */
+    template<typename T>
+    void store(T* const index, const T value) noexcept
+    {
+        std::atomic_ref<T>{*index}.store(value, std::memory_order_release);
+    }
+
+} // namespace
+
+Ring::Ring(boost::asio::io_context& context, const unsigned entries, const size_t buffers) :
+    _context{context},
+    _descriptor{context}
+{
+    io_uring_params params{};
+    /// Reads of idle descriptors may outnumber entries of submission queue
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = 4 * entries;
+    const auto fd = setup(entries, params);
+    if (fd < 0) {
+        throw std::system_error{errno, std::system_category(), "Can't set up io_uring"};
+    }
+    _descriptor.assign(fd);
+
+    if (!(params.features & IORING_FEAT_NODROP)) {
+        throw std::system_error{ENOSYS, std::system_category(), "Kernel may drop completions of io_uring"};
+    }
+
+    _submission_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _completion_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single) {
+        _submission_size = _completion_size = std::max(_submission_size, _completion_size);
+    }
+
+    _submission_ring = map(fd, _submission_size, IORING_OFF_SQ_RING);
+    if (!_submission_ring) {
+        _fail("Can't map submission queue of io_uring");
+    }
+
+    _completion_ring = single ? _submission_ring : map(fd, _completion_size, IORING_OFF_CQ_RING);
+    if (!_completion_ring) {
+        _fail("Can't map completion queue of io_uring");
+    }
+
+    _entries_size = params.sq_entries * sizeof(io_uring_sqe);
+    _entries = static_cast<io_uring_sqe*>(map(fd, _entries_size, IORING_OFF_SQES));
+    if (!_entries) {
+        _fail("Can't map submission entries of io_uring");
+    }
+
+    _submission_head = at<unsigned>(_submission_ring, params.sq_off.head);
+    _submission_tail = at<unsigned>(_submission_ring, params.sq_off.tail);
+    _submission_flags = at<unsigned>(_submission_ring, params.sq_off.flags);
+    _submission_array = at<unsigned>(_submission_ring, params.sq_off.array);
+    _submission_mask = *at<unsigned>(_submission_ring, params.sq_off.ring_mask);
+    _submission_entries = *at<unsigned>(_submission_ring, params.sq_off.ring_entries);
+    _completion_head = at<unsigned>(_completion_ring, params.cq_off.head);
+    _completion_tail = at<unsigned>(_completion_ring, params.cq_off.tail);
+    _completion_mask = *at<unsigned>(_completion_ring, params.cq_off.ring_mask);
+    _completions = at<io_uring_cqe>(_completion_ring, params.cq_off.cqes);
+    _prepared = *_submission_tail;
+
+    if (buffers > 0) {
+        _provide(buffers);
+    }
+
+    _wait();
+}
+
+Ring::~Ring() noexcept
+{
+    /// Operations in flight are canceled by kernel once ring is closed
+    boost::system::error_code ec;
+    _descriptor.close(ec);
+    _unmap();
+}
+
+auto Ring::read(const int fd, void* const data, const size_t size, Handler handler) -> Id
+{
+    const auto id = _next++;
+    auto& operation = _operations[id];
+    operation.kind = Kind::Read;
+    operation.fd = fd;
+    operation.data = static_cast<char*>(data);
+    operation.size = size;
+    /// Empty read selecting buffer would read as much as buffer holds
+    operation.selects = _buffers && size > 0;
+    operation.handler = std::move(handler);
+    _issue(id, operation);
+    return id;
+}
+
+auto Ring::send(const int fd, std::vector<iovec> buffers, Handler handler) -> Id
+{
+    const auto id = _next++;
+    auto& operation = _operations[id];
+    operation.kind = Kind::Send;
+    operation.fd = fd;
+    operation.buffers = std::move(buffers);
+    operation.handler = std::move(handler);
+    _issue(id, operation);
+    return id;
+}
+
+auto Ring::poll(const int fd, Handler handler) -> Id
+{
+    const auto id = _next++;
+    auto& operation = _operations[id];
+    operation.kind = Kind::Poll;
+    operation.fd = fd;
+    operation.handler = std::move(handler);
+    _issue(id, operation);
+    return id;
+}
+
+void Ring::cancel(const Id id)
+{
+    const auto found = _operations.find(id);
+    if (found == _operations.end() || found->second.canceled) {
+        return;
+    }
+
+    /// Operation completed meanwhile isn't retried anymore
+    found->second.canceled = true;
+    _request_cancel(id);
+}
+
+auto Ring::submissions() const noexcept -> size_t
+{
+    return _submissions;
+}
+
+void Ring::_provide(const size_t count)
+{
+    /// Kernel requires amount of buffers to be a power of two
+    _buffer_count = std::bit_floor(std::min(count, kMaxBuffers));
+    _buffer_ring = static_cast<io_uring_buf_ring*>(map(-1, _buffer_count * sizeof(io_uring_buf), 0));
+    _buffers = static_cast<char*>(map(-1, _buffer_count * kBufferSize, 0));
+    if (!_buffer_ring || !_buffers) {
+        _fail("Can't allocate buffers of io_uring");
+    }
+
+    io_uring_buf_reg registration{};
+    registration.ring_addr = reinterpret_cast<uint64_t>(_buffer_ring);
+    registration.ring_entries = static_cast<uint32_t>(_buffer_count);
+    registration.bgid = kBufferGroup;
+    if (register_ring(_descriptor.native_handle(), IORING_REGISTER_PBUF_RING, &registration, 1) != 0) {
+        std::cerr << "Can't register buffers of io_uring: " << std::strerror(errno)
+                  << ", data is read to memory of sessions" << std::endl;
+        _unmap_buffers();
+        return;
+    }
+
+    for (size_t i = 0; i < _buffer_count; ++i) {
+        _recycle(static_cast<uint16_t>(i));
+    }
+}
+
+void Ring::_recycle(const uint16_t index) noexcept
+{
+    /// Entries start at the beginning of ring, whereas member @c bufs
+    /// is shifted by an empty structure in C++
+    auto& buffer = reinterpret_cast<io_uring_buf*>(_buffer_ring)[_buffer_tail & (_buffer_count - 1)];
+    buffer.addr = reinterpret_cast<uint64_t>(_buffers + index * kBufferSize);
+    buffer.len = kBufferSize;
+    buffer.bid = index;
+    store(&_buffer_ring->tail, ++_buffer_tail);
+}
+
+auto Ring::_prepare(const Id id) -> io_uring_sqe&
+{
+    /// Full queue is submitted at once
+    if (_prepared - load(_submission_head) == _submission_entries) {
+        _submit();
+    }
+
+    const auto index = _prepared & _submission_mask;
+    auto& entry = _entries[index];
+    std::memset(&entry, 0, sizeof(entry));
+    entry.user_data = id;
+    _submission_array[index] = index;
+    ++_prepared;
+    _schedule();
+    return entry;
+}
+
+void Ring::_request_cancel(const Id id)
+{
+    auto& entry = _prepare(kIgnored);
+    entry.opcode = IORING_OP_ASYNC_CANCEL;
+    entry.addr = id;
+}
+
+void Ring::_issue(const Id id, Operation& operation)
+{
+    auto& entry = _prepare(id);
+    entry.fd = operation.fd;
+    switch (operation.kind) {
+        case Kind::Read:
+            entry.opcode = IORING_OP_READ;
+            /// Streams are read from their current position
+            entry.off = static_cast<uint64_t>(-1);
+            entry.len = static_cast<uint32_t>(std::min(operation.size, operation.selects ? kBufferSize : operation.size));
+            if (operation.selects) {
+                entry.flags = IOSQE_BUFFER_SELECT;
+                entry.buf_group = kBufferGroup;
+            } else {
+                entry.addr = reinterpret_cast<uint64_t>(operation.data);
+            }
+            break;
+
+        case Kind::Send:
+            /// Message refers to buffers, so it is rebuilt once they are advanced
+            operation.message = {};
+            operation.message.msg_iov = operation.buffers.data();
+            operation.message.msg_iovlen = operation.buffers.size();
+            entry.opcode = IORING_OP_SENDMSG;
+            entry.addr = reinterpret_cast<uint64_t>(&operation.message);
+            entry.len = 1;
+            entry.msg_flags = MSG_NOSIGNAL;
+            break;
+
+        case Kind::Poll:
+            entry.opcode = IORING_OP_POLL_ADD;
+            entry.poll32_events = POLLIN;
+            break;
+    }
+}
+
+void Ring::_await(const Id id, Operation& operation)
+{
+    operation.waiting = true;
+    auto& entry = _prepare(id);
+    entry.opcode = IORING_OP_POLL_ADD;
+    entry.fd = operation.fd;
+    entry.poll32_events = operation.kind == Kind::Send ? POLLOUT : POLLIN;
+}
+
+void Ring::_schedule()
+{
+    if (_scheduled) {
+        return;
+    }
+
+    _scheduled = true;
+    boost::asio::post(
+        _context,
+        [this] {
+            /// Cancelations refused previously are retried along with
+            /// the rest, not on their own
+            for (const auto id : std::exchange(_refused, {})) {
+                if (_operations.contains(id)) {
+                    _request_cancel(id);
+                }
+            }
+
+            _scheduled = false;
+            _submit();
+        }
+    );
+}
+
+void Ring::_submit()
+{
+    store(_submission_tail, _prepared);
+    while (_prepared != load(_submission_head)) {
+        const auto submitted = enter(_descriptor.native_handle(), _prepared - load(_submission_head), 0);
+        if (submitted > 0) {
+            ++_submissions;
+            continue;
+        }
+
+        if (submitted < 0 && errno == EINTR) {
+            continue;
+        }
+
+        /// Kernel is out of room for completions until they are reaped
+        if (submitted < 0 && (errno == EBUSY || errno == EAGAIN)) {
+            _drain();
+            boost::asio::post(_context, [this] { _reap(); });
+            continue;
+        }
+
+        _refuse(submitted < 0 ? errno : EIO);
+        return;
+    }
+}
+
+void Ring::_refuse(const int error)
+{
+    std::cerr << "Can't submit operations to io_uring: " << std::strerror(error) << std::endl;
+
+    /// Kernel consumes entries only once it is entered,
+    /// so those left in queue are taken back
+    const auto head = load(_submission_head);
+    for (auto index = head; index != _prepared; ++index) {
+        const auto& entry = _entries[index & _submission_mask];
+        if (entry.opcode == IORING_OP_ASYNC_CANCEL) {
+            /// Operation being canceled is still owned by kernel
+            _refused.push_back(entry.addr);
+            continue;
+        }
+
+        /// Handlers aren't invoked by operations submitting others
+        boost::asio::post(_context, [this, id = entry.user_data, error] { _complete(id, -error, 0); });
+    }
+    _prepared = head;
+    store(_submission_tail, _prepared);
+}
+
+void Ring::_wait()
+{
+    _descriptor.async_wait(
+        boost::asio::posix::stream_descriptor::wait_read,
+        [this] (const auto ec) {
+            if (ec) {
+                return;
+            }
+
+            _reap();
+            _wait();
+        }
+    );
+}
+
+void Ring::_drain()
+{
+    while (true) {
+        auto head = *_completion_head;
+        const auto tail = load(_completion_tail);
+        for (; head != tail; ++head) {
+            const auto& completion = _completions[head & _completion_mask];
+            _drained.push_back({completion.user_data, completion.res, completion.flags});
+        }
+        store(_completion_head, head);
+
+        /// Completions kept by kernel are moved to the queue once it is entered
+        if (!(load(_submission_flags) & IORING_SQ_CQ_OVERFLOW)) {
+            return;
+        }
+        while (enter(_descriptor.native_handle(), 0, IORING_ENTER_GETEVENTS) < 0 && errno == EINTR) { }
+    }
+}
+
+void Ring::_reap()
+{
+    _drain();
+
+    /// Handlers may drain ring once again meanwhile
+    std::vector<Completion> drained;
+    drained.swap(_drained);
+    for (const auto& completion : drained) {
+        _complete(completion.id, completion.result, completion.flags);
+    }
+
+    drained.clear();
+    if (_drained.empty()) {
+        _drained.swap(drained);
+    }
+}
+
+void Ring::_complete(const Id id, int result, const uint32_t flags)
+{
+    const auto found = _operations.find(id);
+    if (found == _operations.end()) {
+        return;
+    }
+
+    auto& operation = found->second;
+    /// Data read before cancelation took effect is delivered as well,
+    /// so destination stays valid until handler is invoked
+    if (operation.kind == Kind::Read && (flags & IORING_CQE_F_BUFFER)) {
+        const auto index = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+        if (result > 0) {
+            std::memcpy(operation.data, _buffers + index * kBufferSize, static_cast<size_t>(result));
+        }
+        _recycle(index);
+    }
+
+    if (operation.waiting) {
+        /// Descriptor is ready, so operation is retried
+        operation.waiting = false;
+        if (result >= 0 && !operation.canceled) {
+            _issue(id, operation);
+            return;
+        }
+        result = result < 0 ? result : -ECANCELED;
+    } else if (result == -EAGAIN && operation.kind != Kind::Poll && !operation.canceled) {
+        /// Descriptor is nonblocking
+        _await(id, operation);
+        return;
+    } else if (result == -ENOBUFS && operation.selects && !operation.canceled) {
+        /// Every registered buffer is in use
+        operation.selects = false;
+        _issue(id, operation);
+        return;
+    } else if (operation.kind == Kind::Send && result >= 0) {
+        operation.transferred += static_cast<size_t>(result);
+        auto left = static_cast<size_t>(result);
+        auto sent = operation.buffers.begin();
+        for (; sent != operation.buffers.end() && left >= sent->iov_len; ++sent) {
+            left -= sent->iov_len;
+        }
+        operation.buffers.erase(operation.buffers.begin(), sent);
+        if (!operation.buffers.empty()) {
+            operation.buffers.front().iov_base = static_cast<char*>(operation.buffers.front().iov_base) + left;
+            operation.buffers.front().iov_len -= left;
+        }
+
+        if (operation.buffers.empty()) {
+            result = static_cast<int>(operation.transferred);
+        } else if (result > 0 && !operation.canceled) {
+            /// Socket buffer is full, the rest is sent once there is room
+            _issue(id, operation);
+            return;
+        } else {
+            result = operation.canceled ? -ECANCELED : -EPIPE;
+        }
+    }
+
+    auto handler = std::move(operation.handler);
+    _operations.erase(found);
+    handler(result);
+}
+
+void Ring::_unmap_buffers() noexcept
+{
+    if (_buffers) {
+        ::munmap(std::exchange(_buffers, nullptr), _buffer_count * kBufferSize);
+    }
+    if (_buffer_ring) {
+        ::munmap(std::exchange(_buffer_ring, nullptr), _buffer_count * sizeof(io_uring_buf));
+    }
+    _buffer_count = 0;
+}
+
+void Ring::_unmap() noexcept
+{
+    _unmap_buffers();
+    if (_entries) {
+        ::munmap(std::exchange(_entries, nullptr), _entries_size);
+    }
+    if (_completion_ring && _completion_ring != _submission_ring) {
+        ::munmap(_completion_ring, _completion_size);
+    }
+    _completion_ring = nullptr;
+    if (_submission_ring) {
+        ::munmap(std::exchange(_submission_ring, nullptr), _submission_size);
+    }
+}
+
+[[noreturn]]
+void Ring::_fail(const char* const what)
+{
+    const auto error = errno;
+    _unmap();
+    throw std::system_error{error, std::system_category(), what};
+}
+
+} // namespace lab1
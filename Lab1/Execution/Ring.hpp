@@ -0,0 +1,254 @@
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unordered_map>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+namespace lab1 {
+
+/**
+ * @brief io_uring instance of a single event loop.
+ *
+ * Operations are prepared in submission queue and submitted together
+ * at the end of loop turn by a single system call. Descriptor of ring
+ * is waited for by reactor of the loop, so completions are reaped
+ * without system calls once it becomes readable. Reads select one of
+ * buffers registered with kernel only once data arrives, so idle
+ * descriptors don't hold any. Operations which would block are
+ * retried once descriptor is ready, so descriptors may be nonblocking.
+ */
+class Ring
+{
+public:
+    /**
+     * @brief Callback receiving amount of bytes transferred, poll mask
+     *  or negated errno, @c -ECANCELED once operation is canceled.
+     */
+    using Handler = std::function<void(int result)>;
+
+    /**
+     * @brief Identifier of submitted operation.
+     */
+    using Id = uint64_t;
+
+    static constexpr unsigned kDefaultEntries = 1024;
+
+    static constexpr size_t kDefaultBuffers = 256;
+
+    /**
+     * @brief Size of every registered buffer.
+     */
+    static constexpr size_t kBufferSize = 2048;
+
+    /**
+     * @param context Event loop completions are reaped by.
+     * @param entries Size of submission queue.
+     * @param buffers Amount of registered buffers rounded down to a power
+     *  of two, reads are done to memory of caller if there are none.
+     * @throw std::system_error If ring can't be set up.
+     */
+    explicit Ring(boost::asio::io_context& context,
+                  unsigned entries = kDefaultEntries,
+                  size_t buffers = kDefaultBuffers);
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    ~Ring() noexcept;
+
+    /**
+     * @brief Read at most @a size bytes from @a fd to @a data.
+     * @note Data must stay in place until handler is invoked.
+     */
+    auto read(int fd, void* data, size_t size, Handler handler) -> Id;
+
+    /**
+     * @brief Send all @a buffers to socket @a fd, peer closing connection
+     *  doesn't raise @c SIGPIPE.
+     * @note Data referred by buffers must stay in place until handler is invoked.
+     */
+    auto send(int fd, std::vector<iovec> buffers, Handler handler) -> Id;
+
+    /**
+     * @brief Wait until @a fd becomes readable.
+     */
+    auto poll(int fd, Handler handler) -> Id;
+
+    /**
+     * @brief Cancel operation @a id unless it is already completed.
+     * @note Handler is invoked anyway, possibly with data read before
+     *  cancelation took effect, so memory of operation must stay in place
+     *  until then.
+     */
+    void cancel(Id id);
+
+    /**
+     * @brief Amount of system calls submitting operations.
+     */
+    [[nodiscard]]
+    auto submissions() const noexcept -> size_t;
+
+private:
+    enum class Kind
+    {
+        Read,
+        Send,
+        Poll
+    };
+
+    struct Operation
+    {
+        Kind kind;
+        int fd;
+        /// Destination of read
+        char* data = nullptr;
+        size_t size = 0;
+        /// Rest of data to send
+        std::vector<iovec> buffers;
+        msghdr message{};
+        size_t transferred = 0;
+        /// Whether read selects registered buffer
+        bool selects = false;
+        /// Whether descriptor is waited for to retry operation
+        bool waiting = false;
+        bool canceled = false;
+        Handler handler;
+    };
+
+    struct Completion
+    {
+        Id id;
+        int result;
+        uint32_t flags;
+    };
+
+    /**
+     * @brief Register @a count buffers reads select from.
+     */
+    void _provide(size_t count);
+
+    /**
+     * @brief Return registered buffer @a index to kernel.
+     */
+    void _recycle(uint16_t index) noexcept;
+
+    /**
+     * @brief Take entry of submission queue for operation @a id,
+     *  queue is submitted at once if it is full.
+     */
+    auto _prepare(Id id) -> io_uring_sqe&;
+
+    /**
+     * @brief Queue operation @a id once again.
+     */
+    void _issue(Id id, Operation& operation);
+
+    /**
+     * @brief Wait until descriptor of operation @a id would not block.
+     */
+    void _await(Id id, Operation& operation);
+
+    /**
+     * @brief Submit prepared operations at the end of loop turn.
+     */
+    void _schedule();
+
+    /**
+     * @brief Submit every prepared operation.
+     */
+    void _submit();
+
+    /**
+     * @brief Fail operations kernel refuses to accept with @a error.
+     */
+    void _refuse(int error);
+
+    /**
+     * @brief Prepare cancelation of operation @a id.
+     */
+    void _request_cancel(Id id);
+
+    /**
+     * @brief Wait until completions are posted.
+     */
+    void _wait();
+
+    /**
+     * @brief Move posted completions out of completion queue.
+     */
+    void _drain();
+
+    /**
+     * @brief Handle drained completions.
+     */
+    void _reap();
+
+    /**
+     * @brief Handle completion of operation @a id.
+     */
+    void _complete(Id id, int result, uint32_t flags);
+
+    /**
+     * @brief Unmap registered buffers.
+     */
+    void _unmap_buffers() noexcept;
+
+    /**
+     * @brief Unmap memory shared with kernel.
+     */
+    void _unmap() noexcept;
+
+    /**
+     * @brief Unmap memory and throw error of the last system call.
+     */
+    [[noreturn]]
+    void _fail(const char* what);
+
+private:
+    boost::asio::io_context& _context;
+    /// Descriptor of ring waited for by reactor
+    boost::asio::posix::stream_descriptor _descriptor;
+    void* _submission_ring = nullptr;
+    size_t _submission_size = 0;
+    void* _completion_ring = nullptr;
+    size_t _completion_size = 0;
+    io_uring_sqe* _entries = nullptr;
+    size_t _entries_size = 0;
+    unsigned* _submission_head = nullptr;
+    unsigned* _submission_tail = nullptr;
+    unsigned* _submission_flags = nullptr;
+    unsigned* _submission_array = nullptr;
+    unsigned _submission_mask = 0;
+    unsigned _submission_entries = 0;
+    unsigned* _completion_head = nullptr;
+    unsigned* _completion_tail = nullptr;
+    unsigned _completion_mask = 0;
+    io_uring_cqe* _completions = nullptr;
+    /// Tail of submission queue including entries not submitted yet
+    unsigned _prepared = 0;
+    /// Whether submission is going to happen at the end of loop turn
+    bool _scheduled = false;
+    size_t _submissions = 0;
+    io_uring_buf_ring* _buffer_ring = nullptr;
+    char* _buffers = nullptr;
+    size_t _buffer_count = 0;
+    uint16_t _buffer_tail = 0;
+    Id _next = 1;
+    std::unordered_map<Id, Operation> _operations;
+    /// Completions drained, but not handled yet
+    std::vector<Completion> _drained;
+    /// Operations whose cancelation kernel has refused to accept
+    std::vector<Id> _refused;
+};
+
+} // namespace lab1
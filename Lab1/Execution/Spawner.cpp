@@ -0,0 +1,348 @@
+#include <Lab1/Execution/Spawner.hpp>
+
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sched.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sysexits.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+extern char** environ;
+
+namespace lab1 {
+namespace {
+
+    /**
+     * @brief Command line of worker executable evaluating single job.
+     * @note Prepared in advance, since child isn't allowed to allocate.
+     */
+    class Arguments
+    {
+    public:
+        Arguments(const std::string& executable, const PackedJob& job, const Destination* const destination) :
+            _values{
+                std::to_string(job.operation),
+                std::to_string(job.function),
+                std::to_string(job.index)
+            },
+            _argv{
+                executable.c_str(),
+                "--operation", _values[0].c_str(),
+                "--function", _values[1].c_str(),
+                "--index", _values[2].c_str(),
+                nullptr
+            }
+        {
+            if (!destination) {
+                return;
+            }
+
+            /// Result is written to a slot worker maps by descriptor
+            /// or to a pipe shared with other children
+            size_t position = 7;
+            _values[3] = std::to_string(destination->results->event());
+            _values[4] = std::to_string(destination->tag);
+            _argv[position++] = "--event-fd";
+            _argv[position++] = _values[3].c_str();
+            _argv[position++] = "--tag";
+            _argv[position++] = _values[4].c_str();
+            if (const auto memory = destination->results->memory(); memory >= 0) {
+                _values[5] = std::to_string(memory);
+                _argv[position++] = "--results-fd";
+                _argv[position++] = _values[5].c_str();
+            }
+        }
+
+        Arguments(const Arguments&) = delete;
+        Arguments& operator=(const Arguments&) = delete;
+
+        [[nodiscard]]
+        auto argv() const noexcept -> char* const*
+        {
+            return const_cast<char* const*>(_argv.data());
+        }
+
+    private:
+        std::array<std::string, 6> _values;
+        std::array<const char*, 14> _argv;
+    };
+
+    /**
+     * @brief State passed to a child created by clone.
+     */
+    struct CloneState
+    {
+        const char* executable;
+        char* const* argv;
+        int fd;
+        sigset_t mask;
+        /// Applied before exec, if any
+        const Profile* profile;
+        /// Slot worker writes result to, if any
+        const Destination* destination;
+    };
+
+    /**
+     * @brief Entry point of a child created by clone.
+     * @note Memory is shared with the parent, so only async-signal-safe
+     *  functions are allowed.
+     */
+    int clone_main(void* arg) noexcept
+    {
+        const auto& state = *static_cast<const CloneState*>(arg);
+
+        /// Handlers of the parent mustn't run in shared memory
+        for (int sig = 1; sig < NSIG; ++sig) {
+            struct sigaction action;
+            if (::sigaction(sig, nullptr, &action) == 0
+                && action.sa_handler != SIG_IGN
+                && action.sa_handler != SIG_DFL) {
+                action.sa_handler = SIG_DFL;
+                action.sa_flags = 0;
+                ::sigaction(sig, &action, nullptr);
+            }
+        }
+        ::sigprocmask(SIG_SETMASK, &state.mask, nullptr);
+
+        /// Profile is kept across exec
+        if (state.profile) {
+            apply(*state.profile);
+        }
+
+        if (state.destination) {
+            /// Worker inherits descriptors of results
+            const auto memory = state.destination->results->memory();
+            if ((memory >= 0 && ::fcntl(memory, F_SETFD, 0) != 0)
+                || ::fcntl(state.destination->results->event(), F_SETFD, 0) != 0) {
+                ::_exit(EX_OSERR);
+            }
+        } else if (::dup2(state.fd, STDOUT_FILENO) < 0) {
+            /// Result is written to standard output
+            ::_exit(EX_OSERR);
+        }
+
+        ::execve(state.executable, state.argv, environ);
+        ::_exit(EX_UNAVAILABLE);
+    }
+
+} // namespace
+
+void Spawner::async_spawn(const Job& job, const Destination* const destination, Handler handler)
+{
+    handler(spawn(job, destination));
+}
+
+ForkSpawner::ForkSpawner(boost::asio::io_context& context, const Profiles* const profiles) noexcept :
+    _context{context},
+    _profiles{profiles}
+{ }
+
+auto ForkSpawner::spawn(const Job& job, const Destination* const destination) -> std::optional<Child>
+{
+    /// Pipe for communication with child, unless result is written to a slot
+    int fds[2] = {-1, -1};
+    if (!destination && ::pipe2(fds, O_CLOEXEC) != 0) {
+        return {};
+    }
+
+    /// Notify context that we are about to fork
+    _context.notify_fork(boost::asio::io_context::fork_prepare);
+
+    const auto pid = ::fork();
+    if (pid == 0) {
+        /// Notify io_context from child
+        _context.notify_fork(boost::asio::io_context::fork_child);
+        if (_profiles) {
+            apply(_profiles->get(job.origin.priority));
+        }
+        if (destination) {
+            /// Mapping of slots and descriptors of results are inherited
+            std::exit(destination->results->publish(destination->tag, evaluate_value(job)) ? EX_OK : EX_SOFTWARE);
+        }
+        /// Close reading end of a pipe
+        ::close(fds[0]);
+        /// Compute function and write result to pipe
+        std::exit(evaluate(job, fds[1]) ? EX_OK : EX_SOFTWARE);
+    } else if (pid < 0) {
+        /// Rare case that can happen when system has run out of resources,
+        /// request fails while server keeps going
+        std::cerr << "Fork failed with error: " << std::strerror(errno) << std::endl;
+        _context.notify_fork(boost::asio::io_context::fork_parent);
+        if (!destination) {
+            ::close(fds[0]);
+            ::close(fds[1]);
+        }
+        return {};
+    }
+
+    /// Notify io_context from parent
+    _context.notify_fork(boost::asio::io_context::fork_parent);
+    /// Close writing part of a pipe
+    if (!destination) {
+        ::close(fds[1]);
+    }
+
+    return Child{pid, fds[0]};
+}
+
+CloneSpawner::CloneSpawner(std::string executable, const Profiles* const profiles, const size_t stack_size) :
+    _executable{std::move(executable)},
+    _profiles{profiles},
+    _stack_size{stack_size}
+{
+    const auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    _stack_size = (_stack_size + page - 1) / page * page;
+    /// Extra page serves as a guard against overflow
+    _stack = ::mmap(nullptr, _stack_size + page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (_stack == MAP_FAILED) {
+        throw std::system_error{errno, std::system_category(), "Can't allocate stack"};
+    }
+    ::mprotect(_stack, page, PROT_NONE);
+}
+
+CloneSpawner::~CloneSpawner() noexcept
+{
+    ::munmap(_stack, _stack_size + static_cast<size_t>(::sysconf(_SC_PAGESIZE)));
+}
+
+auto CloneSpawner::spawn(const Job& job, const Destination* const destination) -> std::optional<Child>
+{
+    const Arguments arguments{_executable, pack(job), destination};
+
+    int fds[2] = {-1, -1};
+    if (!destination && ::pipe2(fds, O_CLOEXEC) != 0) {
+        return {};
+    }
+
+    CloneState state{
+        _executable.c_str(),
+        arguments.argv(),
+        fds[1],
+        {},
+        _profiles ? &_profiles->get(job.origin.priority) : nullptr,
+        destination
+    };
+
+    /// No signal may be delivered to the child until handlers are reset
+    sigset_t all;
+    ::sigfillset(&all);
+    ::pthread_sigmask(SIG_SETMASK, &all, &state.mask);
+
+    /// Stack grows down, guard page is at the bottom
+    auto* top = static_cast<char*>(_stack) + static_cast<size_t>(::sysconf(_SC_PAGESIZE)) + _stack_size;
+    /// Current thread is suspended until child executes worker
+    const auto pid = ::clone(clone_main, top, CLONE_VM | CLONE_VFORK | SIGCHLD, &state);
+
+    ::pthread_sigmask(SIG_SETMASK, &state.mask, nullptr);
+    if (!destination) {
+        ::close(fds[1]);
+    }
+
+    if (pid < 0) {
+        if (!destination) {
+            ::close(fds[0]);
+        }
+        return {};
+    }
+
+    return Child{pid, fds[0]};
+}
+
+PosixSpawner::PosixSpawner(std::string executable, const Profiles* const profiles) noexcept :
+    _executable{std::move(executable)},
+    _profiles{profiles}
+{ }
+
+auto PosixSpawner::spawn(const Job& job, const Destination* const destination) -> std::optional<Child>
+{
+    const Arguments arguments{_executable, pack(job), destination};
+
+    int fds[2] = {-1, -1};
+    if (!destination && ::pipe2(fds, O_CLOEXEC) != 0) {
+        return {};
+    }
+
+    posix_spawn_file_actions_t actions;
+    ::posix_spawn_file_actions_init(&actions);
+    if (destination) {
+        /// Duplicating descriptor onto itself makes it inherited
+        if (const auto memory = destination->results->memory(); memory >= 0) {
+            ::posix_spawn_file_actions_adddup2(&actions, memory, memory);
+        }
+        ::posix_spawn_file_actions_adddup2(&actions, destination->results->event(), destination->results->event());
+    } else {
+        /// Result is written to standard output
+        ::posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    }
+
+    posix_spawnattr_t attributes;
+    ::posix_spawnattr_init(&attributes);
+    sigset_t signals;
+    ::sigemptyset(&signals);
+    ::posix_spawnattr_setsigmask(&attributes, &signals);
+    ::sigfillset(&signals);
+    ::posix_spawnattr_setsigdefault(&attributes, &signals);
+    ::posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+    pid_t pid;
+    const auto error = ::posix_spawn(&pid, _executable.c_str(), &actions, &attributes, arguments.argv(), environ);
+
+    ::posix_spawnattr_destroy(&attributes);
+    ::posix_spawn_file_actions_destroy(&actions);
+    if (!destination) {
+        ::close(fds[1]);
+    }
+
+    if (error != 0) {
+        if (!destination) {
+            ::close(fds[0]);
+        }
+        return {};
+    }
+
+    /// Child has just started, so it is yet to evaluate anything
+    if (_profiles) {
+        apply(_profiles->get(job.origin.priority), pid);
+    }
+
+    return Child{pid, fds[0]};
+}
+
+PinnedSpawner::PinnedSpawner(Spawner& spawner, Cores cores) noexcept :
+    _spawner{spawner},
+    _cores{std::move(cores)}
+{ }
+
+auto PinnedSpawner::spawn(const Job& job, const Destination* const destination) -> std::optional<Child>
+{
+    auto child = _spawner.spawn(job, destination);
+    if (child) {
+        /// Child which has already exited can't be pinned, which is fine
+        pin(child->pid, _cores);
+    }
+    return child;
+}
+
+void PinnedSpawner::async_spawn(const Job& job, const Destination* const destination, Handler handler)
+{
+    _spawner.async_spawn(
+        job,
+        destination,
+        [this, handler = std::move(handler)] (const std::optional<Child> child) {
+            if (child) {
+                pin(child->pid, _cores);
+            }
+            handler(child);
+        }
+    );
+}
+
+} // namespace lab1
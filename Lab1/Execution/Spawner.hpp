@@ -0,0 +1,195 @@
+#pragma once
+
+#include <Lab1/Execution/Job.hpp>
+#include <Lab1/Execution/Placement.hpp>
+#include <Lab1/Execution/Profile.hpp>
+#include <Lab1/Execution/Results.hpp>
+
+#include <boost/asio/io_context.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <sys/types.h>
+
+namespace lab1 {
+
+/**
+ * @brief Child process evaluating a job.
+ */
+struct Child
+{
+    /**
+     * @brief Identifier of the process.
+     */
+    pid_t pid;
+
+    /**
+     * @brief Reading end of a pipe the serialized result is written to,
+     *  -1 if result is written to results of the event loop.
+     */
+    int fd;
+
+    /**
+     * @brief Descriptor of a process which isn't parented by the server
+     *  and is reaped elsewhere, -1 if the server must reap it itself.
+     */
+    int pidfd = -1;
+};
+
+/**
+ * @brief Slot child writes raw value of its result to instead of
+ *  a pipe of its own.
+ */
+struct Destination
+{
+    Results* results;
+    /// Tag of a slot acquired from results
+    uint64_t tag;
+};
+
+/**
+ * @brief Strategy of creating child processes.
+ */
+class Spawner
+{
+public:
+    /**
+     * @brief Callback receiving created child or empty optional if it
+     *  can't be created.
+     */
+    using Handler = std::function<void(std::optional<Child>)>;
+
+    virtual ~Spawner() = default;
+
+    /**
+     * @brief Create child process evaluating @a job.
+     * @param destination Slot result is written to, if any,
+     *  otherwise it is written to a pipe.
+     * @return Empty optional if process can't be created.
+     */
+    [[nodiscard]]
+    virtual auto spawn(const Job& job, const Destination* destination) -> std::optional<Child> = 0;
+
+    /**
+     * @brief Create child process evaluating @a job without waiting
+     *  for whoever creates it.
+     * @param destination Slot result is written to, if any, it isn't
+     *  referred once call returns.
+     * @note By default child is created right away and @a handler is
+     *  invoked before return.
+     */
+    virtual void async_spawn(const Job& job, const Destination* destination, Handler handler);
+};
+
+/**
+ * @brief Fork server process directly.
+ */
+class ForkSpawner final: public Spawner
+{
+public:
+    /**
+     * @param context Event loop to notify about forks.
+     * @param profiles Profiles children apply before evaluation, if any.
+     */
+    explicit ForkSpawner(boost::asio::io_context& context, const Profiles* profiles = nullptr) noexcept;
+
+    [[nodiscard]]
+    auto spawn(const Job& job, const Destination* destination) -> std::optional<Child> override;
+
+private:
+    boost::asio::io_context& _context;
+    const Profiles* _profiles;
+};
+
+/**
+ * @brief Create child sharing memory with the server until it executes
+ *  worker executable in one-shot mode.
+ *
+ * Neither page tables are copied nor event loop is notified. Child runs
+ * on a small dedicated stack while server thread is suspended.
+ */
+class CloneSpawner final: public Spawner
+{
+public:
+    /**
+     * @brief Default size of a stack child runs on before exec.
+     */
+    static constexpr size_t kDefaultStackSize = 64 * 1024;
+
+    /**
+     * @param executable Path to worker executable.
+     * @param profiles Profiles children apply before exec, if any.
+     * @param stack_size Size of a stack child runs on before exec.
+     * @throw std::system_error If stack can't be allocated.
+     */
+    explicit CloneSpawner(std::string executable,
+                          const Profiles* profiles = nullptr,
+                          size_t stack_size = kDefaultStackSize);
+
+    CloneSpawner(const CloneSpawner&) = delete;
+    CloneSpawner& operator=(const CloneSpawner&) = delete;
+
+    ~CloneSpawner() noexcept override;
+
+    [[nodiscard]]
+    auto spawn(const Job& job, const Destination* destination) -> std::optional<Child> override;
+
+private:
+    std::string _executable;
+    const Profiles* _profiles;
+    size_t _stack_size;
+    void* _stack;
+};
+
+/**
+ * @brief Create child executing worker executable in one-shot mode
+ *  by means of posix_spawn.
+ *
+ * Child can't run any code before exec, so its profile is applied
+ * by the server right after it is created.
+ */
+class PosixSpawner final: public Spawner
+{
+public:
+    /**
+     * @param executable Path to worker executable.
+     * @param profiles Profiles applied to children, if any.
+     */
+    explicit PosixSpawner(std::string executable, const Profiles* profiles = nullptr) noexcept;
+
+    [[nodiscard]]
+    auto spawn(const Job& job, const Destination* destination) -> std::optional<Child> override;
+
+private:
+    std::string _executable;
+    const Profiles* _profiles;
+};
+
+/**
+ * @brief Restrict children created by another spawner to a set of cores.
+ *
+ * Children are pinned by the server right after they are created,
+ * which works regardless of who their parent is.
+ */
+class PinnedSpawner final: public Spawner
+{
+public:
+    /**
+     * @param spawner Spawner actually creating children.
+     * @param cores Cores children are restricted to.
+     */
+    PinnedSpawner(Spawner& spawner, Cores cores) noexcept;
+
+    [[nodiscard]]
+    auto spawn(const Job& job, const Destination* destination) -> std::optional<Child> override;
+
+    void async_spawn(const Job& job, const Destination* destination, Handler handler) override;
+
+private:
+    Spawner& _spawner;
+    Cores _cores;
+};
+
+} // namespace lab1
@@ -0,0 +1,167 @@
+#include <Lab1/Execution/ThreadPool.hpp>
+
+#include <boost/asio/post.hpp>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+namespace lab1 {
+
+/**
+ * @brief Job shared between event loop and pool thread.
+ */
+struct ThreadPool::Record
+{
+    Record(const Job& job, Handler handler) :
+        job{job},
+        handler{std::move(handler)}
+    { }
+
+    const Job job;
+    Interrupt interrupt;
+    /// Accessed from event loop only
+    Handler handler;
+    /// Written by pool thread before record is completed
+    std::optional<int64_t> result;
+    std::atomic<bool> canceled{false};
+};
+
+/**
+ * @brief Job evaluated by a pool thread or waiting for one.
+ */
+class ThreadPool::ThreadTask final: public Backend::Task
+{
+public:
+    explicit ThreadTask(std::shared_ptr<Record> record) noexcept :
+        _record{std::move(record)}
+    { }
+
+    ~ThreadTask() noexcept override
+    {
+        _record->handler = nullptr;
+        _record->canceled.store(true, std::memory_order_relaxed);
+        /// Release thread as soon as possible
+        _record->interrupt.raise();
+    }
+
+private:
+    std::shared_ptr<Record> _record;
+};
+
+ThreadPool::ThreadPool(boost::asio::io_context& context, const size_t size, const Cores& cores) :
+    _context{context},
+    _running(size)
+{
+    _threads.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        _threads.emplace_back([this, i, cores] {
+            pin(0, cores);
+            _run(i);
+        });
+    }
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+    {
+        std::lock_guard lock{_mutex};
+        _stopped = true;
+        for (const auto& record : _running) {
+            if (record) {
+                record->interrupt.raise();
+            }
+        }
+    }
+    _condition.notify_all();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+
+    /// Results nobody is going to handle
+    auto* completion = _completed.exchange(nullptr, std::memory_order_acquire);
+    while (completion) {
+        delete std::exchange(completion, completion->next);
+    }
+}
+
+auto ThreadPool::submit(const Job& job, Handler handler) -> std::unique_ptr<Task>
+{
+    auto record = std::make_shared<Record>(job, std::move(handler));
+    {
+        std::lock_guard lock{_mutex};
+        _queue.push_back(record);
+    }
+    _condition.notify_one();
+
+    return std::make_unique<ThreadTask>(std::move(record));
+}
+
+void ThreadPool::_run(const size_t index)
+{
+    while (true) {
+        std::unique_lock lock{_mutex};
+        _condition.wait(lock, [this] { return _stopped || !_queue.empty(); });
+        if (_stopped) {
+            return;
+        }
+
+        auto record = std::move(_queue.front());
+        _queue.pop_front();
+        if (record->canceled.load(std::memory_order_relaxed)) {
+            /// Nobody waits for the result
+            continue;
+        }
+
+        _running[index] = record;
+        lock.unlock();
+
+        record->result = evaluate(record->job, record->interrupt);
+
+        lock.lock();
+        _running[index].reset();
+        lock.unlock();
+
+        _push(std::move(record));
+    }
+}
+
+void ThreadPool::_push(std::shared_ptr<Record> record)
+{
+    auto* completion = new Completion{std::move(record), nullptr};
+    auto* head = _completed.load(std::memory_order_relaxed);
+    do {
+        completion->next = head;
+    } while (!_completed.compare_exchange_weak(head, completion, std::memory_order_release, std::memory_order_relaxed));
+
+    if (!head) {
+        /// Queue was empty, so nobody has asked event loop to drain it yet
+        boost::asio::post(_context, [this] { _drain(); });
+    }
+}
+
+void ThreadPool::_drain()
+{
+    auto* completion = _completed.exchange(nullptr, std::memory_order_acquire);
+
+    /// Restore order of completion
+    Completion* ordered = nullptr;
+    while (completion) {
+        auto* next = completion->next;
+        completion->next = ordered;
+        ordered = completion;
+        completion = next;
+    }
+
+    while (ordered) {
+        std::unique_ptr<Completion> current{std::exchange(ordered, ordered->next)};
+        auto& record = *current->record;
+        if (record.handler) {
+            auto handler = std::move(record.handler);
+            record.handler = nullptr;
+            handler(record.result);
+        }
+    }
+}
+
+} // namespace lab1
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Lab1/Execution/Backend.hpp>
+#include <Lab1/Execution/Placement.hpp>
+
+#include <atomic>
+#include <boost/asio/io_context.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lab1 {
+
+/**
+ * @brief Backend evaluating jobs on a bounded pool of threads
+ *  inside the server.
+ *
+ * Finished jobs are pushed to a lock-free queue, which is drained
+ * from event loop, so pool threads never touch sessions.
+ */
+class ThreadPool final: public Backend
+{
+public:
+    /**
+     * @param context Event loop to deliver results to.
+     * @param size Amount of threads.
+     * @param cores Cores threads are restricted to, any if empty.
+     */
+    ThreadPool(boost::asio::io_context& context, size_t size, const Cores& cores = {});
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Interrupt running jobs and join threads.
+     */
+    ~ThreadPool() noexcept override;
+
+    [[nodiscard]]
+    auto submit(const Job& job, Handler handler) -> std::unique_ptr<Task> override;
+
+private:
+    class ThreadTask;
+
+    struct Record;
+
+    /**
+     * @brief Node of a queue of finished jobs.
+     */
+    struct Completion
+    {
+        std::shared_ptr<Record> record;
+        Completion* next;
+    };
+
+    void _run(size_t index);
+
+    void _push(std::shared_ptr<Record> record);
+
+    void _drain();
+
+private:
+    boost::asio::io_context& _context;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<std::shared_ptr<Record>> _queue;
+    std::vector<std::shared_ptr<Record>> _running;
+    bool _stopped = false;
+    std::atomic<Completion*> _completed{nullptr};
+    std::vector<std::thread> _threads;
+};
+
+} // namespace lab1
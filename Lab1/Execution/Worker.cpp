@@ -0,0 +1,116 @@
+#include <Lab1/Execution/Worker.hpp>
+
+#include <Lab1/Execution/WorkerProtocol.hpp>
+
+#include <cerrno>
+#include <sys/socket.h>
+#include <sysexits.h>
+#include <thread>
+
+namespace lab1 {
+
+Worker::Worker(const int channel) noexcept :
+    _channel{channel}
+{ }
+
+auto Worker::run() -> int
+{
+    std::thread computation{[this] { _compute(); }};
+
+    while (true) {
+        worker::Request request;
+        const auto received = ::recv(_channel, &request, sizeof(request), 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (received <= 0) {
+            /// Server has gone
+            break;
+        }
+
+        if (received != sizeof(request)) {
+            continue;
+        }
+
+        std::unique_lock lock{_mutex};
+        switch (request.command) {
+        case worker::Command::Submit: {
+            auto job = unpack(request.job);
+            if (!job || _pending || _current) {
+                /// Malformed request or server doesn't respect our capacity
+                lock.unlock();
+                _reply(request.id, {}, false);
+                break;
+            }
+
+            _interrupt.reset();
+            _pending.emplace(request.id, std::move(*job));
+            lock.unlock();
+            _condition.notify_one();
+            break;
+        }
+        case worker::Command::Cancel:
+            if (_pending && _pending->first == request.id) {
+                /// Evaluation isn't started yet
+                _pending.reset();
+                lock.unlock();
+                _reply(request.id, {}, true);
+            } else if (_current == request.id) {
+                _interrupt.raise();
+            }
+            break;
+        }
+    }
+
+    {
+        std::lock_guard lock{_mutex};
+        _stopped = true;
+    }
+    _interrupt.raise();
+    _condition.notify_one();
+    computation.join();
+
+    return EX_OK;
+}
+
+void Worker::_compute()
+{
+    while (true) {
+        std::unique_lock lock{_mutex};
+        _condition.wait(lock, [this] { return _stopped || _pending; });
+        if (_stopped) {
+            return;
+        }
+
+        const auto [id, job] = std::move(*_pending);
+        _pending.reset();
+        _current = id;
+        lock.unlock();
+
+        const auto result = evaluate(job, _interrupt);
+
+        lock.lock();
+        /// Become idle before server is notified
+        _current.reset();
+        lock.unlock();
+
+        _reply(id, result, !result);
+    }
+}
+
+void Worker::_reply(const uint64_t id, const std::optional<int64_t> result, const bool canceled) noexcept
+{
+    worker::Response response{};
+    response.id = id;
+    if (result) {
+        response.status = worker::Status::Done;
+        response.value = *result;
+    } else {
+        response.status = canceled ? worker::Status::Canceled : worker::Status::Failed;
+    }
+
+    while (::send(_channel, &response, sizeof(response), MSG_NOSIGNAL) < 0 && errno == EINTR) { }
+}
+
+} // namespace lab1
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Lab1/Execution/Job.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace lab1 {
+
+/**
+ * @brief Long-lived process evaluating jobs received over a channel
+ *  one at a time.
+ */
+class Worker
+{
+public:
+    /**
+     * @param channel Sequenced packet socket connected to the server.
+     */
+    explicit Worker(int channel) noexcept;
+
+    /**
+     * @brief Serve requests until channel is closed.
+     * @return Exit code of the process.
+     */
+    [[nodiscard]]
+    auto run() -> int;
+
+private:
+    void _compute();
+
+    void _reply(uint64_t id, std::optional<int64_t> result, bool canceled) noexcept;
+
+private:
+    int _channel;
+    Interrupt _interrupt;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::optional<std::pair<uint64_t, Job>> _pending;
+    std::optional<uint64_t> _current;
+    bool _stopped = false;
+};
+
+} // namespace lab1
@@ -0,0 +1,212 @@
+#include <Lab1/Execution/WorkerPool.hpp>
+
+#include <algorithm>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/system/error_code.hpp>
+#include <cerrno>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <system_error>
+#include <sysexits.h>
+#include <unistd.h>
+
+namespace lab1 {
+
+/**
+ * @brief Job dispatched to a worker or waiting for one.
+ */
+class WorkerPool::WorkerTask final: public Backend::Task
+{
+public:
+    WorkerTask(WorkerPool& pool, const uint64_t id) noexcept :
+        _pool{pool},
+        _id{id}
+    { }
+
+    ~WorkerTask() noexcept override
+    {
+        _pool._cancel(_id);
+    }
+
+private:
+    WorkerPool& _pool;
+    uint64_t _id;
+};
+
+WorkerPool::WorkerPool(boost::asio::io_context& context,
+                       const std::string& executable,
+                       const size_t size,
+                       const Cores& cores) :
+    _context{context}
+{
+    for (size_t i = 0; i < size; ++i) {
+        int sockets[2];
+        if (::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets) != 0) {
+            throw std::system_error{errno, std::system_category(), "Can't create worker channel"};
+        }
+
+        /// Prepare arguments before fork
+        const auto fd = std::to_string(sockets[1]);
+        const char* const argv[] = {executable.c_str(), "--fd", fd.c_str(), nullptr};
+
+        const auto pid = ::fork();
+        if (pid == 0) {
+            pin(0, cores);
+            ::close(sockets[0]);
+            /// Let worker inherit its end of channel
+            ::fcntl(sockets[1], F_SETFD, 0);
+            ::execv(executable.c_str(), const_cast<char* const*>(argv));
+            ::_exit(EX_UNAVAILABLE);
+        }
+
+        ::close(sockets[1]);
+        if (pid < 0) {
+            const auto error = errno;
+            ::close(sockets[0]);
+            throw std::system_error{error, std::system_category(), "Can't start worker"};
+        }
+
+        auto& worker = *_workers.emplace_back(std::make_unique<Worker>(_context));
+        worker.pid = pid;
+        worker.channel.assign(boost::asio::generic::seq_packet_protocol{AF_UNIX, 0}, sockets[0]);
+        _receive(worker);
+    }
+}
+
+WorkerPool::~WorkerPool() noexcept
+{
+    for (auto& worker : _workers) {
+        /// Worker exits as soon as channel is closed
+        boost::system::error_code ec;
+        worker->channel.close(ec);
+        ::waitpid(worker->pid, nullptr, 0);
+    }
+}
+
+auto WorkerPool::submit(const Job& job, Handler handler) -> std::unique_ptr<Task>
+{
+    const auto id = ++_next_id;
+    _handlers.emplace(id, std::move(handler));
+    _queue.emplace_back(id, job);
+    _dispatch();
+
+    return std::make_unique<WorkerTask>(*this, id);
+}
+
+void WorkerPool::_cancel(const uint64_t id)
+{
+    /// Result isn't needed anymore
+    _handlers.erase(id);
+
+    const auto queued = std::find_if(
+        _queue.begin(),
+        _queue.end(),
+        [id] (const auto& entry) { return entry.first == id; }
+    );
+    if (queued != _queue.end()) {
+        _queue.erase(queued);
+        return;
+    }
+
+    for (auto& worker : _workers) {
+        if (worker->current == id) {
+            /// Worker stays busy until it acknowledges cancelation
+            const worker::Request request{id, worker::Command::Cancel, {}};
+            boost::system::error_code ec;
+            worker->channel.send(boost::asio::buffer(&request, sizeof(request)), 0, ec);
+            return;
+        }
+    }
+}
+
+void WorkerPool::_dispatch()
+{
+    bool alive = false;
+    for (auto& worker : _workers) {
+        if (!worker->channel.is_open()) {
+            continue;
+        }
+
+        alive = true;
+        if (worker->current || _queue.empty()) {
+            continue;
+        }
+
+        auto [id, job] = std::move(_queue.front());
+        _queue.pop_front();
+
+        const worker::Request request{id, worker::Command::Submit, pack(job)};
+        boost::system::error_code ec;
+        worker->channel.send(boost::asio::buffer(&request, sizeof(request)), 0, ec);
+        if (ec) {
+            /// Worker will be reported as gone by pending receive
+            boost::asio::post(_context, [this, id = id] { _complete(id, {}); });
+            continue;
+        }
+
+        worker->current = id;
+    }
+
+    if (!alive) {
+        /// Nobody can evaluate queued jobs
+        for (const auto& [id, job] : _queue) {
+            boost::asio::post(_context, [this, id = id] { _complete(id, {}); });
+        }
+        _queue.clear();
+    }
+}
+
+void WorkerPool::_receive(Worker& worker)
+{
+    worker.channel.async_receive(
+        boost::asio::buffer(&worker.response, sizeof(worker.response)),
+        worker.flags,
+        [this, &worker] (const auto ec, const auto size) {
+            if (ec == boost::asio::error::operation_aborted) {
+                return;
+            }
+
+            if (ec || size == 0) {
+                std::cerr << "Worker " << worker.pid << " has gone" << std::endl;
+                boost::system::error_code ignored;
+                worker.channel.close(ignored);
+                if (const auto id = std::exchange(worker.current, std::nullopt)) {
+                    _complete(*id, {});
+                }
+                _dispatch();
+                return;
+            }
+
+            if (size == sizeof(worker.response) && worker.current == worker.response.id) {
+                /// Worker becomes idle
+                worker.current.reset();
+                if (worker.response.status == worker::Status::Done) {
+                    _complete(worker.response.id, worker.response.value);
+                } else {
+                    _complete(worker.response.id, {});
+                }
+            }
+
+            _dispatch();
+            _receive(worker);
+        }
+    );
+}
+
+void WorkerPool::_complete(const uint64_t id, const std::optional<int64_t> result)
+{
+    const auto found = _handlers.find(id);
+    if (found == _handlers.end()) {
+        /// Job was canceled
+        return;
+    }
+
+    auto handler = std::move(found->second);
+    _handlers.erase(found);
+    handler(result);
+}
+
+} // namespace lab1
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <Lab1/Execution/Backend.hpp>
+#include <Lab1/Execution/Placement.hpp>
+#include <Lab1/Execution/WorkerProtocol.hpp>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/generic/seq_packet_protocol.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace lab1 {
+
+/**
+ * @brief Backend dispatching jobs to a fixed set of long-lived
+ *  worker processes.
+ *
+ * Each worker evaluates one job at a time, excess jobs are queued.
+ * Canceled jobs are interrupted without terminating workers.
+ */
+class WorkerPool final: public Backend
+{
+public:
+    /**
+     * @brief Start workers.
+     * @param context Event loop to communicate with workers from.
+     * @param executable Path to worker executable.
+     * @param size Amount of workers.
+     * @param cores Cores workers are restricted to, any if empty.
+     * @throw std::system_error If workers can't be started.
+     */
+    WorkerPool(boost::asio::io_context& context,
+               const std::string& executable,
+               size_t size,
+               const Cores& cores = {});
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief Stop workers and wait for them.
+     */
+    ~WorkerPool() noexcept override;
+
+    [[nodiscard]]
+    auto submit(const Job& job, Handler handler) -> std::unique_ptr<Task> override;
+
+private:
+    class WorkerTask;
+
+    struct Worker
+    {
+        explicit Worker(boost::asio::io_context& context) :
+            channel{context}
+        { }
+
+        pid_t pid = -1;
+        boost::asio::generic::seq_packet_protocol::socket channel;
+        std::optional<uint64_t> current;
+        worker::Response response{};
+        boost::asio::socket_base::message_flags flags = 0;
+    };
+
+    void _cancel(uint64_t id);
+
+    void _dispatch();
+
+    void _receive(Worker& worker);
+
+    void _complete(uint64_t id, std::optional<int64_t> result);
+
+private:
+    boost::asio::io_context& _context;
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::deque<std::pair<uint64_t, Job>> _queue;
+    std::unordered_map<uint64_t, Handler> _handlers;
+    uint64_t _next_id = 0;
+};
+
+} // namespace lab1
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Lab1/Execution/Job.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace lab1::worker {
+
+/**
+ * @brief Kind of request sent to a worker.
+ */
+enum class Command : uint8_t
+{
+    /**
+     * @brief Start evaluation of a job.
+     */
+    Submit,
+
+    /**
+     * @brief Interrupt evaluation of a job.
+     */
+    Cancel
+};
+
+/**
+ * @brief Single frame sent to a worker.
+ */
+struct Request
+{
+    uint64_t id;
+    Command command;
+    PackedJob job;
+};
+
+/**
+ * @brief Outcome of a job.
+ */
+enum class Status : uint8_t
+{
+    Done,
+    Failed,
+    Canceled
+};
+
+/**
+ * @brief Single frame sent back by a worker.
+ */
+struct Response
+{
+    uint64_t id;
+    Status status;
+    /// Raw value of result, see @a evaluate_value
+    int64_t value;
+};
+
+static_assert(std::is_trivially_copyable_v<Request>);
+static_assert(std::is_trivially_copyable_v<Response>);
+
+} // namespace lab1::worker
@@ -0,0 +1,478 @@
+#include <Lab1/Execution/Zygote.hpp>
+
+#include <Lab1/Execution/Pidfd.hpp>
+
+#include <algorithm>
+#include <array>
+#include <boost/system/error_code.hpp>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <system_error>
+#include <sysexits.h>
+#include <unistd.h>
+#include <utility>
+
+namespace lab1 {
+namespace {
+
+    /**
+     * @brief Maximal amount of descriptors attached to successful reply.
+     */
+    constexpr size_t kDescriptors = 2;
+
+    /**
+     * @brief Collect all finished children of helper process.
+     */
+    void reap(int /*sig*/) noexcept
+    {
+        const auto saved = errno;
+        while (::waitpid(-1, nullptr, WNOHANG) > 0) { }
+        errno = saved;
+    }
+
+    /**
+     * @brief Send @a reply with optional @a fds attached.
+     */
+    void send_reply(const int socket, zygote::Reply reply, const int* const fds = nullptr, const size_t count = 0) noexcept
+    {
+        iovec iov{&reply, sizeof(reply)};
+        msghdr message{};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kDescriptors)];
+        if (count > 0) {
+            message.msg_control = control;
+            message.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+            auto* header = CMSG_FIRSTHDR(&message);
+            header->cmsg_level = SOL_SOCKET;
+            header->cmsg_type = SCM_RIGHTS;
+            header->cmsg_len = CMSG_LEN(sizeof(int) * count);
+            std::memcpy(CMSG_DATA(header), fds, sizeof(int) * count);
+        }
+
+        while (::sendmsg(socket, &message, MSG_NOSIGNAL) < 0 && errno == EINTR) { }
+    }
+
+    /**
+     * @brief State of helper process.
+     */
+    struct Helper
+    {
+        const Profiles* profiles;
+        const std::vector<Results*>& results;
+        /// Channels of event loops which haven't gone yet
+        std::vector<pollfd> channels;
+        sigset_t chld;
+    };
+
+    /**
+     * @brief Create child evaluating job of @a request received
+     *  over @a channel and reply with it.
+     */
+    void create(Helper& helper, const int channel, const zygote::Request& request, const bool whole) noexcept
+    {
+        const auto job = whole ? unpack(request.job) : std::nullopt;
+        /// Only slots known since helper was forked are mapped
+        const bool known = !request.results
+            || (std::find(helper.results.begin(), helper.results.end(), request.results) != helper.results.end()
+                && Results::index(request.tag) < request.results->capacity());
+        int fds[2] = {-1, -1};
+        if (!job || !known || (!request.results && ::pipe2(fds, O_CLOEXEC) != 0)) {
+            send_reply(channel, {request.id, -1});
+            return;
+        }
+
+        /// Child must not be reaped before its descriptor is obtained
+        sigset_t previous;
+        ::sigprocmask(SIG_BLOCK, &helper.chld, &previous);
+
+        const auto pid = ::fork();
+        if (pid == 0) {
+            ::signal(SIGCHLD, SIG_DFL);
+            ::sigprocmask(SIG_SETMASK, &previous, nullptr);
+            for (const auto& polled : helper.channels) {
+                ::close(polled.fd);
+            }
+            if (helper.profiles) {
+                apply(helper.profiles->get(job->origin.priority));
+            }
+            if (request.results) {
+                ::_exit(request.results->publish(request.tag, evaluate_value(*job)) ? EX_OK : EX_SOFTWARE);
+            }
+            ::close(fds[0]);
+            /// Compute function and write result to pipe
+            ::_exit(evaluate(*job, fds[1]) ? EX_OK : EX_SOFTWARE);
+        }
+
+        if (!request.results) {
+            ::close(fds[1]);
+        }
+        const int pidfd = pid > 0 ? pidfd::open(pid) : -1;
+        if (pid > 0 && pidfd < 0) {
+            ::kill(pid, SIGKILL);
+        }
+
+        ::sigprocmask(SIG_SETMASK, &previous, nullptr);
+
+        if (pidfd < 0) {
+            if (!request.results) {
+                ::close(fds[0]);
+            }
+            send_reply(channel, {request.id, -1});
+            return;
+        }
+
+        if (request.results) {
+            send_reply(channel, {request.id, pid}, &pidfd, 1);
+        } else {
+            const std::array descriptors{fds[0], pidfd};
+            send_reply(channel, {request.id, pid}, descriptors.data(), descriptors.size());
+            ::close(fds[0]);
+        }
+        ::close(pidfd);
+    }
+
+    /**
+     * @brief Handle every request received over @a channel so far.
+     * @return Whether event loop still holds the channel.
+     */
+    bool receive(Helper& helper, const int channel) noexcept
+    {
+        while (true) {
+            zygote::Request request;
+            const auto received = ::recv(channel, &request, sizeof(request), MSG_DONTWAIT);
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (received < 0) {
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+
+            if (received == 0) {
+                return false;
+            }
+
+            create(helper, channel, request, received == sizeof(request));
+        }
+    }
+
+    /**
+     * @brief Main loop of helper process.
+     */
+    [[noreturn]]
+    void serve(const std::vector<int>& channels, const Profiles* const profiles, const std::vector<Results*>& results) noexcept
+    {
+        /// Don't outlive the server
+        ::prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+        /// Children are reaped as soon as they finish
+        struct sigaction action{};
+        action.sa_handler = reap;
+        action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+        ::sigemptyset(&action.sa_mask);
+        ::sigaction(SIGCHLD, &action, nullptr);
+
+        Helper helper{profiles, results, {}, {}};
+        ::sigemptyset(&helper.chld);
+        ::sigaddset(&helper.chld, SIGCHLD);
+        for (const auto channel : channels) {
+            helper.channels.push_back({channel, POLLIN, 0});
+        }
+
+        /// Server has gone once every event loop has closed its channel
+        while (!helper.channels.empty()) {
+            if (::poll(helper.channels.data(), helper.channels.size(), -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ::_exit(EX_OSERR);
+            }
+
+            for (auto polled = helper.channels.begin(); polled != helper.channels.end();) {
+                if (polled->revents == 0 || receive(helper, polled->fd)) {
+                    ++polled;
+                    continue;
+                }
+
+                ::close(polled->fd);
+                polled = helper.channels.erase(polled);
+            }
+        }
+
+        ::_exit(EX_OK);
+    }
+
+} // namespace
+
+Zygote::Zygote(const Profiles* const profiles, std::vector<Results*> results, const size_t channels)
+{
+    std::vector<int> helper;
+    const auto close_all = [&] {
+        for (const auto fd : _channels) {
+            ::close(fd);
+        }
+        for (const auto fd : helper) {
+            ::close(fd);
+        }
+    };
+
+    for (size_t i = 0; i < std::max<size_t>(1, channels); ++i) {
+        int sockets[2];
+        if (::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets) != 0) {
+            const auto error = errno;
+            close_all();
+            throw std::system_error{error, std::system_category(), "Can't create zygote channel"};
+        }
+
+        _channels.push_back(sockets[0]);
+        helper.push_back(sockets[1]);
+    }
+
+    _pid = ::fork();
+    if (_pid == 0) {
+        for (const auto fd : _channels) {
+            ::close(fd);
+        }
+        serve(helper, profiles, results);
+    } else if (_pid < 0) {
+        const auto error = errno;
+        close_all();
+        throw std::system_error{error, std::system_category(), "Can't fork zygote"};
+    }
+
+    for (const auto fd : helper) {
+        ::close(fd);
+    }
+}
+
+Zygote::~Zygote() noexcept
+{
+    /// Helper exits as soon as channels are closed
+    for (const auto fd : _channels) {
+        ::close(fd);
+    }
+    ::waitpid(_pid, nullptr, 0);
+}
+
+int Zygote::channel(const size_t index) const noexcept
+{
+    return _channels[index];
+}
+
+ZygoteSpawner::ZygoteSpawner(boost::asio::io_context& context, const Zygote& zygote, const size_t channel) :
+    _channel{context}
+{
+    /// Channel of zygote stays open until helper is waited for
+    const auto fd = ::fcntl(zygote.channel(channel), F_DUPFD_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::system_error{errno, std::system_category(), "Can't duplicate zygote channel"};
+    }
+
+    _channel.assign(boost::asio::generic::seq_packet_protocol{AF_UNIX, 0}, fd);
+    _wait_receive();
+}
+
+auto ZygoteSpawner::spawn(const Job& job, const Destination* const destination) -> std::optional<Child>
+{
+    std::optional<std::optional<Child>> spawned;
+    _request(job, destination, [&spawned] (const std::optional<Child> child) { spawned = child; });
+
+    while (!spawned) {
+        pollfd polled{_channel.native_handle(), static_cast<short>(_queue.empty() ? POLLIN : POLLIN | POLLOUT), 0};
+        if (::poll(&polled, 1, -1) < 0 && errno != EINTR) {
+            _fail();
+        } else if (!_send() || !_receive()) {
+            _fail();
+        }
+    }
+
+    return *spawned;
+}
+
+void ZygoteSpawner::async_spawn(const Job& job, const Destination* const destination, Handler handler)
+{
+    _request(job, destination, std::move(handler));
+}
+
+void ZygoteSpawner::_request(const Job& job, const Destination* const destination, Handler handler)
+{
+    zygote::Request request{};
+    request.id = ++_next_id;
+    request.job = pack(job);
+    if (destination) {
+        request.results = destination->results;
+        request.tag = destination->tag;
+    }
+
+    /// Pipe isn't created for result written to results of event loop
+    _pending.emplace(request.id, Pending{std::move(handler), destination ? 1 : kDescriptors});
+    _queue.push_back(request);
+    if (!_send()) {
+        _fail();
+    }
+}
+
+bool ZygoteSpawner::_send()
+{
+    while (!_queue.empty()) {
+        const auto sent = ::send(_channel.native_handle(), &_queue.front(), sizeof(zygote::Request), MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            /// Helper is yet to catch up
+            if (!_sending) {
+                _wait_send();
+            }
+            return true;
+        }
+
+        if (sent != sizeof(zygote::Request)) {
+            return false;
+        }
+
+        _queue.pop_front();
+    }
+
+    return true;
+}
+
+void ZygoteSpawner::_wait_send()
+{
+    _sending = true;
+    _channel.async_wait(
+        boost::asio::generic::seq_packet_protocol::socket::wait_write,
+        [this] (const auto ec) {
+            _sending = false;
+            if (ec == boost::asio::error::operation_aborted) {
+                return;
+            }
+
+            if (ec || !_send()) {
+                _fail();
+            }
+        }
+    );
+}
+
+void ZygoteSpawner::_wait_receive()
+{
+    _channel.async_wait(
+        boost::asio::generic::seq_packet_protocol::socket::wait_read,
+        [this] (const auto ec) {
+            if (ec == boost::asio::error::operation_aborted) {
+                return;
+            }
+
+            if (ec || !_receive()) {
+                _fail();
+                return;
+            }
+
+            _wait_receive();
+        }
+    );
+}
+
+bool ZygoteSpawner::_receive()
+{
+    while (true) {
+        zygote::Reply reply{};
+        iovec iov{&reply, sizeof(reply)};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kDescriptors)];
+        msghdr message{};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        const auto received = ::recvmsg(_channel.native_handle(), &message, MSG_CMSG_CLOEXEC | MSG_DONTWAIT);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (received < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        if (received == 0) {
+            /// Helper has gone
+            return false;
+        }
+
+        /// Every descriptor received is owned by the server now,
+        /// whether reply is valid or not
+        std::array<int, kDescriptors> fds{-1, -1};
+        size_t count = 0;
+        for (auto* header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS) {
+                continue;
+            }
+
+            for (size_t i = 0; i < (header->cmsg_len - CMSG_LEN(0)) / sizeof(int); ++i, ++count) {
+                int fd;
+                std::memcpy(&fd, CMSG_DATA(header) + i * sizeof(int), sizeof(int));
+                if (count < fds.size()) {
+                    fds[count] = fd;
+                } else {
+                    ::close(fd);
+                }
+            }
+        }
+
+        const bool whole = received == sizeof(reply) && (message.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) == 0;
+        const auto pending = whole ? _pending.find(reply.id) : _pending.end();
+        if (pending == _pending.end() || reply.pid <= 0 || count != pending->second.descriptors) {
+            /// Nobody is able to track child, get rid of it
+            for (const auto fd : fds) {
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+            }
+            if (whole && reply.pid > 0) {
+                ::kill(reply.pid, SIGKILL);
+            }
+            if (pending != _pending.end()) {
+                auto handler = std::move(pending->second.handler);
+                _pending.erase(pending);
+                handler({});
+            }
+            continue;
+        }
+
+        auto handler = std::move(pending->second.handler);
+        const auto descriptors = pending->second.descriptors;
+        _pending.erase(pending);
+        handler(descriptors == 1 ? Child{reply.pid, -1, fds[0]} : Child{reply.pid, fds[0], fds[1]});
+    }
+}
+
+void ZygoteSpawner::_fail()
+{
+    if (_channel.is_open()) {
+        std::cerr << "Zygote has gone" << std::endl;
+    }
+
+    boost::system::error_code ec;
+    _channel.close(ec);
+    _queue.clear();
+
+    /// Handlers may request children again, which fail at once
+    auto pending = std::move(_pending);
+    _pending.clear();
+    for (auto& [id, request] : pending) {
+        request.handler({});
+    }
+}
+
+} // namespace lab1
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <Lab1/Execution/Job.hpp>
+#include <Lab1/Execution/Profile.hpp>
+#include <Lab1/Execution/Results.hpp>
+#include <Lab1/Execution/Spawner.hpp>
+
+#include <boost/asio/generic/seq_packet_protocol.hpp>
+#include <boost/asio/io_context.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <sys/types.h>
+#include <unordered_map>
+#include <vector>
+
+namespace lab1 {
+namespace zygote {
+
+/**
+ * @brief Request of a single job sent to helper process.
+ */
+struct Request
+{
+    uint64_t id;
+    PackedJob job;
+    /// Slots inherited by helper or null if result is written to a pipe
+    Results* results;
+    uint64_t tag;
+};
+
+/**
+ * @brief Reply of helper process for a single job.
+ * @note Result pipe, unless result is written to a slot, and process
+ *  descriptor are attached as ancillary data on success.
+ */
+struct Reply
+{
+    uint64_t id;
+    pid_t pid;
+};
+
+} // namespace zygote
+
+/**
+ * @brief Helper process forked at startup, which creates children
+ *  on behalf of event loops.
+ *
+ * Helper process keeps its image tiny, so cost of creating children
+ * doesn't depend on how large the server has grown. Children are
+ * parented and reaped by the helper, server controls them through
+ * process descriptors. Every event loop talks to the helper over
+ * a channel of its own, see @a ZygoteSpawner.
+ */
+class Zygote
+{
+public:
+    /**
+     * @brief Fork helper process.
+     * @param profiles Profiles children apply before evaluation, if any,
+     *  copied by the helper.
+     * @param results Slots children may write results to, inherited
+     *  by the helper, so they must be created before.
+     * @param channels Amount of channels, one for every event loop.
+     * @note Must be constructed before any threads and event loops
+     *  are started.
+     * @throw std::system_error If helper can't be created.
+     */
+    explicit Zygote(const Profiles* profiles = nullptr, std::vector<Results*> results = {}, size_t channels = 1);
+
+    Zygote(const Zygote&) = delete;
+    Zygote& operator=(const Zygote&) = delete;
+
+    /**
+     * @brief Close channels and wait for helper.
+     * @note Helper exits once every duplicate of channels is closed too.
+     */
+    ~Zygote() noexcept;
+
+    /**
+     * @brief Descriptor of channel of @a index owned by zygote.
+     */
+    [[nodiscard]]
+    int channel(size_t index) const noexcept;
+
+private:
+    pid_t _pid;
+    std::vector<int> _channels;
+};
+
+/**
+ * @brief Spawner delegating process creation to zygote over a channel
+ *  dedicated to an event loop.
+ *
+ * Requests are sent without waiting for replies, which are received
+ * by the event loop, so neither loop blocks nor loops contend with each
+ * other while children are created.
+ */
+class ZygoteSpawner final: public Spawner
+{
+public:
+    /**
+     * @param context Event loop replies are received by.
+     * @param zygote Helper process creating children.
+     * @param channel Index of a channel of the loop.
+     * @throw std::system_error If channel can't be duplicated.
+     */
+    ZygoteSpawner(boost::asio::io_context& context, const Zygote& zygote, size_t channel);
+
+    /**
+     * @note Blocks until reply arrives, replies to requests sent
+     *  asynchronously which arrive meanwhile are handled too.
+     */
+    [[nodiscard]]
+    auto spawn(const Job& job, const Destination* destination) -> std::optional<Child> override;
+
+    void async_spawn(const Job& job, const Destination* destination, Handler handler) override;
+
+private:
+    /**
+     * @brief Request waiting for its reply.
+     */
+    struct Pending
+    {
+        Handler handler;
+        /// Amount of descriptors attached to successful reply
+        size_t descriptors;
+    };
+
+    /**
+     * @brief Queue request of @a job and send as many queued ones
+     *  as channel accepts.
+     */
+    void _request(const Job& job, const Destination* destination, Handler handler);
+
+    /**
+     * @brief Send queued requests until channel is full.
+     * @return Whether channel is still usable.
+     */
+    bool _send();
+
+    /**
+     * @brief Wait until queued requests can be sent.
+     */
+    void _wait_send();
+
+    /**
+     * @brief Wait until replies arrive.
+     */
+    void _wait_receive();
+
+    /**
+     * @brief Handle every reply received so far.
+     * @return Whether channel is still usable.
+     */
+    bool _receive();
+
+    /**
+     * @brief Fail every request once helper has gone.
+     */
+    void _fail();
+
+private:
+    boost::asio::generic::seq_packet_protocol::socket _channel;
+    std::deque<zygote::Request> _queue;
+    std::unordered_map<uint64_t, Pending> _pending;
+    uint64_t _next_id = 0;
+    bool _sending = false;
+};
+
+} // namespace lab1
@@ -0,0 +1,144 @@
+#include <Lab1/Server/Balancer.hpp>
+
+#include <Lab1/Server/Server.hpp>
+#include <Lab1/Server/Session.hpp>
+
+#include <boost/asio/post.hpp>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+namespace lab1 {
+
+Balancer::Balancer(const size_t threshold) noexcept :
+    _threshold{threshold}
+{ }
+
+auto Balancer::add(boost::asio::io_context& context, Server& server) -> size_t
+{
+    _loops.push_back(std::make_unique<Loop>(context, server));
+    return _loops.size() - 1;
+}
+
+auto Balancer::wait(const size_t loop, std::weak_ptr<Session> session, const size_t activity) -> Ticket
+{
+    auto& current = *_loops[loop];
+    std::lock_guard lock{current.mutex};
+    const auto ticket = current.next++;
+    current.waiting.emplace(ticket, Waiting{std::move(session), activity});
+    current.active.emplace(activity, ticket);
+    return ticket;
+}
+
+void Balancer::leave(const size_t loop, const Ticket ticket)
+{
+    auto& current = *_loops[loop];
+    std::lock_guard lock{current.mutex};
+    const auto found = current.waiting.find(ticket);
+    if (found == current.waiting.end()) {
+        return;
+    }
+
+    current.active.erase({found->second.activity, ticket});
+    current.waiting.erase(found);
+}
+
+void Balancer::started(const size_t loop)
+{
+    _loops[loop]->load.fetch_add(1, std::memory_order_relaxed);
+    _started.fetch_add(1, std::memory_order_relaxed);
+    _balance();
+}
+
+void Balancer::finished(const size_t loop)
+{
+    _loops[loop]->load.fetch_sub(1, std::memory_order_relaxed);
+    _balance();
+}
+
+void Balancer::settle()
+{
+    _settled.store(_started.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    _moving.store(false, std::memory_order_release);
+}
+
+void Balancer::move(const size_t loop,
+                    const boost::asio::ip::tcp& protocol,
+                    const boost::asio::ip::tcp::socket::native_handle_type fd,
+                    std::string buffer,
+                    const bool binary)
+{
+    auto& target = *_loops[loop];
+    boost::asio::post(
+        target.context,
+        [this, &server = target.server, protocol, fd, buffer = std::move(buffer), binary] () mutable {
+            server.adopt(protocol, fd, std::move(buffer), binary);
+            settle();
+        }
+    );
+}
+
+void Balancer::_balance()
+{
+    size_t busiest = 0;
+    size_t idlest = 0;
+    size_t maximum = 0;
+    size_t minimum = SIZE_MAX;
+    for (size_t i = 0; i < _loops.size(); ++i) {
+        const auto load = _loops[i]->load.load(std::memory_order_relaxed);
+        if (load > maximum) {
+            maximum = load;
+            busiest = i;
+        }
+        if (load < minimum) {
+            minimum = load;
+            idlest = i;
+        }
+    }
+
+    if (maximum <= minimum + _threshold) {
+        return;
+    }
+
+    /// Loads change only once requests of the moved session arrive
+    const auto started = _started.load(std::memory_order_relaxed);
+    if (started - _settled.load(std::memory_order_relaxed) < _threshold) {
+        return;
+    }
+
+    if (_moving.exchange(true, std::memory_order_acquire)) {
+        return;
+    }
+
+    /// Steal session whose requests are the most likely to come,
+    /// moving silent one changes nothing
+    auto& victim = *_loops[busiest];
+    std::weak_ptr<Session> session;
+    {
+        std::lock_guard lock{victim.mutex};
+        if (victim.active.empty() || victim.active.rbegin()->first == 0) {
+            _moving.store(false, std::memory_order_release);
+            return;
+        }
+
+        const auto most = std::prev(victim.active.end());
+        const auto found = victim.waiting.find(most->second);
+        session = std::move(found->second.session);
+        victim.waiting.erase(found);
+        victim.active.erase(most);
+    }
+
+    /// Session is touched by its own loop only
+    boost::asio::post(
+        victim.context,
+        [this, session = std::move(session), idlest] {
+            if (const auto stolen = session.lock()) {
+                stolen->migrate(idlest);
+            } else {
+                settle();
+            }
+        }
+    );
+}
+
+} // namespace lab1
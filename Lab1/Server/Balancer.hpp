@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace lab1 {
+
+class Server;
+class Session;
+
+/**
+ * @brief Balancer of sessions between event loops.
+ *
+ * Tracks amount of requests being served by every loop. Sessions waiting
+ * for the next request are registered by their loop along with amount of
+ * requests they have sent recently, and once the busiest loop serves more
+ * requests than the idlest one by a threshold, the most active waiting
+ * session is stolen from it and moved to the idlest loop together with
+ * its socket, so its next requests land there.
+ *
+ * Moved session isn't serving anything, so loads stay the same until its
+ * requests arrive. Hence a single session is being moved at a time, and
+ * the next one is stolen only once as many requests as the threshold are
+ * started since, instead of every loop stealing on each request.
+ */
+class Balancer
+{
+public:
+    /**
+     * @brief Identifier of a session waiting for request.
+     */
+    using Ticket = uint64_t;
+
+    /**
+     * @param threshold Difference in amount of requests being served
+     *  sessions are moved at.
+     */
+    explicit Balancer(size_t threshold) noexcept;
+
+    Balancer(const Balancer&) = delete;
+    Balancer& operator=(const Balancer&) = delete;
+
+    /**
+     * @brief Register event loop served by @a server.
+     * @note Must be called before any loop is started.
+     * @return Index of the loop.
+     */
+    auto add(boost::asio::io_context& context, Server& server) -> size_t;
+
+    /**
+     * @brief Mark @a session of a @a loop as waiting for request,
+     *  so it may be moved to another loop.
+     * @param activity Amount of requests session has sent recently.
+     */
+    [[nodiscard]]
+    auto wait(size_t loop, std::weak_ptr<Session> session, size_t activity) -> Ticket;
+
+    /**
+     * @brief Mark session as no longer waiting, unless it is already
+     *  stolen by another loop.
+     */
+    void leave(size_t loop, Ticket ticket);
+
+    /**
+     * @brief Notify that @a loop started serving request.
+     */
+    void started(size_t loop);
+
+    /**
+     * @brief Notify that @a loop finished serving request.
+     */
+    void finished(size_t loop);
+
+    /**
+     * @brief Notify that session asked to move is either moved
+     *  or stays on its loop, so another one may be moved.
+     */
+    void settle();
+
+    /**
+     * @brief Continue serving connection @a fd by @a loop.
+     * @param buffer Data received from client, but not processed yet.
+     * @param binary Whether client speaks binary protocol.
+     */
+    void move(size_t loop,
+              const boost::asio::ip::tcp& protocol,
+              boost::asio::ip::tcp::socket::native_handle_type fd,
+              std::string buffer,
+              bool binary);
+
+private:
+    struct Waiting
+    {
+        std::weak_ptr<Session> session;
+        size_t activity;
+    };
+
+    struct Loop
+    {
+        Loop(boost::asio::io_context& context, Server& server) noexcept :
+            context{context},
+            server{server}
+        { }
+
+        boost::asio::io_context& context;
+        Server& server;
+        /// Amount of requests being served
+        std::atomic<size_t> load{0};
+        std::mutex mutex;
+        /// Sessions waiting for request
+        std::unordered_map<Ticket, Waiting> waiting;
+        /// Activity and ticket of waiting sessions, the most active last
+        std::set<std::pair<size_t, Ticket>> active;
+        Ticket next = 0;
+    };
+
+    /**
+     * @brief Move session from the busiest loop to the idlest one
+     *  if they differ enough.
+     */
+    void _balance();
+
+private:
+    size_t _threshold;
+    std::vector<std::unique_ptr<Loop>> _loops;
+    /// Whether a session is being moved
+    std::atomic<bool> _moving{false};
+    /// Amount of requests started by every loop
+    std::atomic<size_t> _started{0};
+    /// Amount of requests started once the last session was moved
+    std::atomic<size_t> _settled{0};
+};
+
+} // namespace lab1
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <Lab1/Execution/Job.hpp>
+#include <Lab1/Server/Operations.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+namespace lab1 {
+namespace binary {
+
+/**
+ * @brief First byte of a connection selecting binary protocol.
+ * @note Never starts a text request.
+ */
+constexpr uint8_t kMagic = 0xB1;
+
+/**
+ * @brief Opcode of cancelation, opcodes of requests hold index
+ *  of operation in @a Operation variant in the low nibble and
+ *  priority class in the high one, @a kDefaultPriority or one
+ *  more than value of @a Priority.
+ */
+constexpr uint8_t kCancel = 0xFF;
+
+/**
+ * @brief Priority class of request is the one of the session.
+ */
+constexpr uint8_t kDefaultPriority = 0;
+
+/**
+ * @brief Maximal size of a varint encoding 64-bit value.
+ */
+constexpr size_t kMaxVarintSize = 10;
+
+/**
+ * @brief Maximal size of a request frame without its size byte:
+ *  opcode, id and index.
+ */
+constexpr size_t kMaxRequestSize = 1 + 2 * kMaxVarintSize;
+
+/**
+ * @brief Maximal size of a reply frame: size, status, id and result.
+ */
+constexpr size_t kMaxReplySize = 2 + kMaxVarintSize + sizeof(uint64_t);
+
+static_assert(std::variant_size_v<Operation> <= 0x0F);
+static_assert(kPriorities < 0x0F);
+
+/**
+ * @brief Status of a reply, results are sent with the first two only.
+ */
+enum class Status : uint8_t
+{
+    Result,
+    ShortCircuit,
+    Canceled,
+    OutOfRange,
+    Internal,
+    Invalid,
+    Duplicate,
+    Unknown,
+    TooMany,
+    Busy
+};
+
+/**
+ * @brief Request decoded from a frame.
+ */
+struct Request
+{
+    /**
+     * @brief Operation to evaluate or empty optional for cancelation.
+     */
+    std::optional<Operation> operation;
+
+    /**
+     * @brief Identifier of request chosen by client.
+     */
+    uint64_t id = 0;
+
+    /**
+     * @brief Index of predefined case.
+     */
+    uint64_t index = 0;
+
+    /**
+     * @brief Priority class or empty optional for the one of the session.
+     */
+    std::optional<Priority> priority;
+};
+
+/**
+ * @brief Outcome of decoding.
+ */
+enum class Decoded
+{
+    /// Request is decoded
+    Complete,
+    /// More data is required
+    Incomplete,
+    /// Frame can't be decoded, framing is lost
+    Malformed
+};
+
+/**
+ * @brief Buffer reply is encoded to.
+ */
+using Frame = std::array<char, kMaxReplySize>;
+
+/**
+ * @brief Write @a value as a sequence of 7-bit groups, least
+ *  significant first.
+ * @return Amount of bytes written.
+ */
+[[nodiscard]]
+constexpr auto encode_varint(uint64_t value, char* const output) noexcept -> size_t
+{
+    size_t size = 0;
+    while (value >= 0x80) {
+        output[size++] = static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    output[size++] = static_cast<char>(value);
+    return size;
+}
+
+/**
+ * @brief Read varint from the beginning of @a input and skip it.
+ * @return Whether value is read.
+ */
+[[nodiscard]]
+constexpr bool decode_varint(std::string_view& input, uint64_t& value) noexcept
+{
+    value = 0;
+    for (size_t i = 0; i < input.size() && i < kMaxVarintSize; ++i) {
+        const auto byte = static_cast<uint8_t>(input[i]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+        if (!(byte & 0x80)) {
+            input.remove_prefix(i + 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Decode request from the beginning of @a input in the
+ *  following format:
+ *  <size:u8><opcode:u8><id:varint>[<index:varint>]
+ *  where size counts bytes following it and index is absent
+ *  in cancelation.
+ * @param consumed Set to size of the frame once request is decoded.
+ */
+[[nodiscard]]
+constexpr auto decode(std::string_view input, Request& request, size_t& consumed) noexcept -> Decoded
+{
+    if (input.empty()) {
+        return Decoded::Incomplete;
+    }
+
+    const size_t size = static_cast<uint8_t>(input.front());
+    if (size == 0 || size > kMaxRequestSize) {
+        return Decoded::Malformed;
+    }
+
+    if (input.size() < size + 1) {
+        return Decoded::Incomplete;
+    }
+
+    auto payload = input.substr(1, size);
+    const auto opcode = static_cast<uint8_t>(payload.front());
+    payload.remove_prefix(1);
+    if (!decode_varint(payload, request.id)) {
+        return Decoded::Malformed;
+    }
+
+    request.priority.reset();
+    if (opcode == kCancel) {
+        request.operation.reset();
+        request.index = 0;
+    } else {
+        const size_t priority = opcode >> 4;
+        if (priority > kPriorities) {
+            return Decoded::Malformed;
+        }
+        if (priority != kDefaultPriority) {
+            request.priority = static_cast<Priority>(priority - 1);
+        }
+
+        request.operation = from_index(opcode & 0x0F);
+        if (!request.operation || !decode_varint(payload, request.index)) {
+            return Decoded::Malformed;
+        }
+    }
+
+    /// Frame must be filled entirely
+    if (!payload.empty()) {
+        return Decoded::Malformed;
+    }
+
+    consumed = size + 1;
+    return Decoded::Complete;
+}
+
+/**
+ * @brief Encode reply to request @a id in the following format:
+ *  <size:u8><status:u8><id:varint>[<value>]
+ *  where size counts bytes following it and value is present
+ *  in results only.
+ * @param value Result written as little endian integer
+ *  of its own width.
+ * @return Encoded part of @a frame.
+ */
+template<typename T = bool>
+[[nodiscard]]
+constexpr auto encode(const Status status,
+                      const uint64_t id,
+                      Frame& frame,
+                      const std::optional<T> value = {}) noexcept -> std::string_view
+{
+    static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(uint64_t));
+
+    size_t size = 1;
+    frame[size++] = static_cast<char>(status);
+    size += encode_varint(id, frame.data() + size);
+    if (value) {
+        const auto bits = static_cast<uint64_t>(*value);
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            frame[size++] = static_cast<char>(bits >> (8 * i));
+        }
+    }
+
+    frame[0] = static_cast<char>(size - 1);
+    return {frame.data(), size};
+}
+
+} // namespace binary
+} // namespace lab1
@@ -0,0 +1,59 @@
+#include <Lab1/Server/Cache.hpp>
+
+namespace lab1 {
+
+Cache::Cache(const size_t capacity) :
+    _capacity{capacity}
+{
+    _index.reserve(_capacity);
+}
+
+auto Cache::hits() const noexcept -> size_t
+{
+    return _hits.load(std::memory_order_relaxed);
+}
+
+auto Cache::misses() const noexcept -> size_t
+{
+    return _misses.load(std::memory_order_relaxed);
+}
+
+auto Cache::_get(const Key key) -> std::optional<Value>
+{
+    std::lock_guard lock{_mutex};
+    const auto found = _index.find(key);
+    if (found == _index.end()) {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+
+    /// Entry becomes the most recently used one
+    _entries.splice(_entries.begin(), _entries, found->second);
+    _hits.fetch_add(1, std::memory_order_relaxed);
+    return found->second->second;
+}
+
+void Cache::_put(const Key key, const binary::Status status, const int64_t value)
+{
+    if (_capacity == 0) {
+        return;
+    }
+
+    std::lock_guard lock{_mutex};
+    if (const auto found = _index.find(key); found != _index.end()) {
+        found->second->second = {status, value};
+        _entries.splice(_entries.begin(), _entries, found->second);
+        return;
+    }
+
+    if (_entries.size() == _capacity) {
+        /// Evict the least recently used entry
+        _index.erase(_entries.back().first);
+        _entries.pop_back();
+    }
+
+    _entries.emplace_front(key, Value{status, value});
+    _index.emplace(key, _entries.begin());
+}
+
+} // namespace lab1
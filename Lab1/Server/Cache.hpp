@@ -0,0 +1,107 @@
+#pragma once
+
+#include <Lab1/Server/Binary.hpp>
+#include <Lab1/Server/Operations.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace lab1 {
+
+/**
+ * @brief Bounded cache of final results of requests.
+ *
+ * Predefined cases are deterministic, so result of an operation on
+ * a case never changes. Results and short circuits are kept until
+ * the least recently used ones are evicted. Safe to use from multiple
+ * threads.
+ */
+class Cache
+{
+public:
+    /**
+     * @brief Final outcome of a request: result or short circuit
+     *  with its value.
+     */
+    template<typename Op>
+    using Entry = std::pair<binary::Status, typename Op::value_type>;
+
+    /**
+     * @param capacity Maximal amount of results kept.
+     */
+    explicit Cache(size_t capacity);
+
+    Cache(const Cache&) = delete;
+    Cache& operator=(const Cache&) = delete;
+
+    /**
+     * @brief Find outcome of operation on case @a index.
+     * @return Empty optional if it isn't known.
+     */
+    template<typename Op>
+    [[nodiscard]]
+    auto get(const size_t index) -> std::optional<Entry<Op>>
+    {
+        const auto found = _get(_key<Op>(index));
+        if (!found) {
+            return {};
+        }
+
+        return Entry<Op>{found->first, static_cast<typename Op::value_type>(found->second)};
+    }
+
+    /**
+     * @brief Remember outcome of operation on case @a index.
+     */
+    template<typename Op>
+    void put(const size_t index, const binary::Status status, const typename Op::value_type value)
+    {
+        _put(_key<Op>(index), status, static_cast<int64_t>(value));
+    }
+
+    /**
+     * @brief Amount of requests answered from cache.
+     */
+    [[nodiscard]]
+    auto hits() const noexcept -> size_t;
+
+    /**
+     * @brief Amount of requests missing in cache.
+     */
+    [[nodiscard]]
+    auto misses() const noexcept -> size_t;
+
+private:
+    using Key = uint64_t;
+    using Value = std::pair<binary::Status, int64_t>;
+
+    template<typename Op>
+    [[nodiscard]]
+    static auto _key(const size_t index) noexcept -> Key
+    {
+        /// Operations are told apart by their index in variant
+        return static_cast<Key>(Operation{Op{}}.index()) << 32 | static_cast<uint32_t>(index);
+    }
+
+    [[nodiscard]]
+    auto _get(Key key) -> std::optional<Value>;
+
+    void _put(Key key, binary::Status status, int64_t value);
+
+private:
+    size_t _capacity;
+    std::mutex _mutex;
+    /// Entries, most recently used first
+    std::list<std::pair<Key, Value>> _entries;
+    std::unordered_map<Key, std::list<std::pair<Key, Value>>::iterator> _index;
+    std::atomic<size_t> _hits{0};
+    std::atomic<size_t> _misses{0};
+};
+
+} // namespace lab1
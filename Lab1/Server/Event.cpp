@@ -0,0 +1,32 @@
+#include <Lab1/Server/Event.hpp>
+
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/system/error_code.hpp>
+
+namespace lab1 {
+
+Event::Event(boost::asio::io_context& context) :
+    _timer{context}
+{ }
+
+void Event::notify() noexcept
+{
+    _notified = true;
+    boost::system::error_code ec;
+    _timer.cancel(ec);
+}
+
+auto Event::wait() -> boost::asio::awaitable<void>
+{
+    if (!_notified) {
+        /// Timer never expires, it is canceled by notification
+        boost::system::error_code ec;
+        _timer.expires_at(boost::asio::steady_timer::time_point::max());
+        co_await _timer.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+    }
+
+    _notified = false;
+}
+
+} // namespace lab1
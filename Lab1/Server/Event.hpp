@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Lab1/Execution/Awaitable.hpp>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+namespace lab1 {
+
+/**
+ * @brief Notification a coroutine can wait for without polling.
+ */
+class Event
+{
+public:
+    explicit Event(boost::asio::io_context& context);
+
+    /**
+     * @brief Wake up waiting coroutine or let the next wait
+     *  complete immediately.
+     */
+    void notify() noexcept;
+
+    /**
+     * @brief Suspend coroutine until event is notified.
+     * @note Notification is consumed.
+     */
+    [[nodiscard]]
+    auto wait() -> boost::asio::awaitable<void>;
+
+private:
+    boost::asio::steady_timer _timer;
+    bool _notified = false;
+};
+
+} // namespace lab1
@@ -3,9 +3,11 @@
 #include <Lab1/3rdparty/demofuncs.hpp>
 
 #include <charconv>
+#include <cstddef>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
 
 namespace lab1 {
@@ -237,4 +239,26 @@ constexpr auto from_string(const std::string_view str) noexcept -> std::optional
     return {};
 }
 
+namespace detail {
+
+    template<size_t... Is>
+    [[nodiscard]]
+    constexpr auto from_index(const size_t index, std::index_sequence<Is...>) noexcept -> std::optional<Operation>
+    {
+        std::optional<Operation> result;
+        ((index == Is ? (result = std::variant_alternative_t<Is, Operation>{}, true) : false) || ...);
+        return result;
+    }
+
+} // namespace detail
+
+/**
+ * @brief Construct operation by its index in @a Operation variant.
+ */
+[[nodiscard]]
+constexpr auto from_index(const size_t index) noexcept -> std::optional<Operation>
+{
+    return detail::from_index(index, std::make_index_sequence<std::variant_size_v<Operation>>{});
+}
+
 } // namespace lab1
@@ -1,21 +1,73 @@
 #include <Lab1/Server/Server.hpp>
 
+#include <Lab1/Server/Balancer.hpp>
 #include <Lab1/Server/Session.hpp>
+#include <Lab1/Server/Weights.hpp>
 
-#include <boost/asio/spawn.hpp>
+#include <atomic>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
 #include <boost/system/error_code.hpp>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <string_view>
+#include <unistd.h>
 #include <utility>
+#include <vector>
 
 namespace lab1 {
+namespace {
+
+    /**
+     * @brief Identifier of the next session of any server.
+     */
+    std::atomic<uint64_t> next_session{0};
+
+} // namespace
 
 Server::Server(boost::asio::io_context& context,
+               Backend& backend,
                const boost::asio::ip::address& address,
-               const uint16_t port) :
+               const uint16_t port,
+               const bool reuse_port,
+               Balancer* const balancer,
+               Cache* const cache,
+               const Weights* const weights,
+               Ring* const ring) :
     _context{context},
-    _acceptor{_context, {address, port}}
-{ }
+    _backend{backend},
+    _acceptor{_context},
+    _balancer{balancer},
+    _cache{cache},
+    _weights{weights},
+    _ring{ring}
+{
+    const boost::asio::ip::tcp::endpoint endpoint{address, port};
+    _acceptor.open(endpoint.protocol());
+    _acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address{true});
+    if (reuse_port) {
+        _acceptor.set_option(boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>{true});
+    }
+    _acceptor.bind(endpoint);
+
+    if (_balancer) {
+        _loop = _balancer->add(_context, *this);
+    }
+}
+
+Server::~Server() noexcept
+{
+    /// Sessions outliving server mustn't notify it
+    for (const auto& weak : _sessions) {
+        if (const auto session = weak.lock()) {
+            session->detach();
+        }
+    }
+}
 
 void Server::start()
 {
@@ -25,29 +77,127 @@ void Server::start()
     std::cout << "Server started listening on " << _acceptor.local_endpoint() << std::endl;
 
     /// Start main loop of connections accepting
-    boost::asio::spawn(
-        _context,
-        [this] (boost::asio::yield_context yield) {
-            boost::system::error_code ec;
-            boost::asio::ip::tcp::socket socket{_context};
-            while (_acceptor.is_open()) {
-                _acceptor.async_accept(socket, yield[ec]);
-                if (ec) {
-                    std::cerr << "Acceptor failed with message: " << ec.message() << std::endl;
-                }
-
-                /// Start serving client
-                std::make_shared<Session>(_context, std::move(socket))->start();                                                                                         
-            }            
-        }
-    );
+    boost::asio::co_spawn(_context, _accept(), boost::asio::detached);
 }
 
-void Server::stop()
+void Server::stop(Stopped stopped)
 {
     std::cout << "Server asked to stop" << std::endl;
     /// Stop accepting incoming connections
-    _acceptor.cancel();
+    boost::system::error_code ec;
+    _acceptor.close(ec);
+
+    _stopping = true;
+    _stopped = std::move(stopped);
+
+    /// Sessions may be finished while being stopped
+    std::vector<std::shared_ptr<Session>> sessions;
+    for (const auto& weak : _sessions) {
+        if (auto session = weak.lock()) {
+            sessions.push_back(std::move(session));
+        }
+    }
+    for (const auto& session : sessions) {
+        session->stop();
+    }
+    sessions.clear();
+
+    if (_sessions.empty() && _stopped) {
+        std::exchange(_stopped, nullptr)();
+    }
+}
+
+auto Server::_accept() -> boost::asio::awaitable<void>
+{
+    boost::system::error_code ec;
+    boost::asio::ip::tcp::socket socket{_context};
+    while (_acceptor.is_open()) {
+        co_await _acceptor.async_accept(socket, boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+        if (ec) {
+            if (ec != boost::asio::error::operation_aborted) {
+                std::cerr << "Acceptor failed with message: " << ec.message() << std::endl;
+            }
+            continue;
+        }
+
+        _serve(std::move(socket), true);
+    }
+}
+
+void Server::adopt(const boost::asio::ip::tcp& protocol,
+                   const boost::asio::ip::tcp::socket::native_handle_type fd,
+                   std::string buffer,
+                   const bool binary)
+{
+    boost::system::error_code ec;
+    boost::asio::ip::tcp::socket socket{_context};
+    socket.assign(protocol, fd, ec);
+    if (ec) {
+        ::close(fd);
+        return;
+    }
+
+    if (_stopping) {
+        /// Client is disconnected as any other one
+        return;
+    }
+
+    _serve(std::move(socket), false, std::move(buffer), binary);
+}
+
+auto Server::_origin(const boost::asio::ip::tcp::socket& socket) const -> Origin
+{
+    Origin origin;
+    origin.session = next_session.fetch_add(1, std::memory_order_relaxed);
+
+    boost::system::error_code ec;
+    const auto address = socket.remote_endpoint(ec).address();
+    if (ec) {
+        return origin;
+    }
+
+    /// Clients are told apart by their address
+    if (address.is_v4()) {
+        origin.client = address.to_v4().to_uint();
+    } else {
+        const auto bytes = address.to_v6().to_bytes();
+        origin.client = std::hash<std::string_view>{}({reinterpret_cast<const char*>(bytes.data()), bytes.size()});
+    }
+
+    if (_weights) {
+        origin.weight = _weights->weight(address);
+    }
+    return origin;
+}
+
+void Server::_serve(boost::asio::ip::tcp::socket socket, const bool greet, std::string buffer, const bool binary)
+{
+    const auto origin = _origin(socket);
+
+    /// Server is notified once session is finished
+    const auto position = _sessions.emplace(_sessions.end());
+    auto session = std::make_shared<Session>(
+        _context,
+        _backend,
+        std::move(socket),
+        [this, position] {
+            _sessions.erase(position);
+            if (_stopping && _sessions.empty() && _stopped) {
+                std::exchange(_stopped, nullptr)();
+            }
+        },
+        _balancer,
+        _loop,
+        _cache,
+        origin,
+        _ring
+    );
+    *position = session;
+    if (greet) {
+        session->start();
+    } else {
+        session->resume(std::move(buffer), binary);
+    }
 }
 
 } // namespace lab1
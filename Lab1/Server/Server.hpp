@@ -1,27 +1,68 @@
 #pragma once
 
+#include <Lab1/Execution/Awaitable.hpp>
+#include <Lab1/Execution/Backend.hpp>
+#include <Lab1/Execution/Job.hpp>
+
 #include <boost/asio/ip/address.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/io_context.hpp>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
 
 namespace lab1 {
 
+class Balancer;
+class Cache;
+class Ring;
+class Weights;
+class Session;
+
 /**
  * @brief Server for lab work.
  */
 class Server
 {
 public:
+    /**
+     * @brief Callback notified once server is stopped.
+     */
+    using Stopped = std::function<void()>;
+
     /**
      * @brief Construct server object.
      * @param context Reference to execution context.
+     * @param backend Backend to evaluate functions with.
      * @param address Address to listen to incoming connections.
      * @param port Port to bind address to.
+     * @param reuse_port Whether other servers are allowed to listen to
+     *  the same port, so kernel balances connections between them.
+     * @param balancer Balancer moving sessions between servers
+     *  of different event loops, if any.
+     * @param cache Cache of results shared by servers, if any.
+     * @param weights Shares of evaluations clients are entitled to,
+     *  every client is treated equally otherwise.
+     * @param ring Ring sockets of sessions are read and written by,
+     *  reactor is used otherwise.
      */
     Server(boost::asio::io_context& context,
+           Backend& backend,
            const boost::asio::ip::address& address,
-           uint16_t port);
+           uint16_t port,
+           bool reuse_port = false,
+           Balancer* balancer = nullptr,
+           Cache* cache = nullptr,
+           const Weights* weights = nullptr,
+           Ring* ring = nullptr);
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    ~Server() noexcept;
 
     /**
      * @brief Start serving requests.
@@ -29,13 +70,55 @@ public:
     void start();
 
     /**
-     * @brief Gracefully shutdown the server.
+     * @brief Gracefully shutdown the server: stop accepting connections
+     *  and finish sessions once their current requests are served.
+     * @param stopped Invoked once every session is finished.
+     */
+    void stop(Stopped stopped = {});
+
+    /**
+     * @brief Continue serving connection moved from another event loop.
+     * @param fd Socket of connection, owned by server since now.
+     * @param buffer Data received from client, but not processed yet.
+     * @param binary Whether client speaks binary protocol.
+     */
+    void adopt(const boost::asio::ip::tcp& protocol,
+               boost::asio::ip::tcp::socket::native_handle_type fd,
+               std::string buffer,
+               bool binary);
+
+private:
+    /**
+     * @brief Start session serving @a socket.
+     * @param greet Whether session is new, otherwise it is resumed
+     *  with @a buffer in protocol chosen by client.
+     */
+    void _serve(boost::asio::ip::tcp::socket socket, bool greet, std::string buffer = {}, bool binary = false);
+
+    /**
+     * @brief Identify client connected by @a socket.
+     */
+    [[nodiscard]]
+    auto _origin(const boost::asio::ip::tcp::socket& socket) const -> Origin;
+
+    /**
+     * @brief Accept connections until acceptor is closed.
      */
-    void stop();
+    auto _accept() -> boost::asio::awaitable<void>;
 
 private:
     boost::asio::io_context& _context;
+    Backend& _backend;
     boost::asio::ip::tcp::acceptor _acceptor;
+    std::list<std::weak_ptr<Session>> _sessions;
+    Stopped _stopped;
+    bool _stopping = false;
+    Balancer* _balancer;
+    /// Index of event loop in balancer
+    size_t _loop = 0;
+    Cache* _cache;
+    const Weights* _weights;
+    Ring* _ring;
 };
 
 } // namespace lab1
@@ -3,19 +3,27 @@
 #include <Lab1/Server/Operations.hpp>
 
 #include <algorithm>
-#include <array>
 #include <boost/asio/buffer.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/error.hpp>
 #include <boost/asio/read.hpp>
 #include <boost/asio/read_until.hpp>
-#include <boost/asio/spawn.hpp>
-#include <boost/asio/system_timer.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/write.hpp>
 #include <boost/system/error_code.hpp>
-#include <cstdlib>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
-#include <sysexits.h>
-#include <tuple>
+#include <string>
+#include <string_view>
+#include <sys/uio.h>
+#include <type_traits>
 #include <utility>
+#include <variant>
+#include <vector>
 
 namespace lab1 {
 namespace {
@@ -79,6 +87,7 @@ namespace {
         "    Provide operation and index to retrieve predefined functions attributes.\n"
         "    Apply operation to functions result.\n"
         "    Submit \"q\" for immediate cancelation.\n"
+        "    Submit \"priority <class>\" to change class of the following requests.\n"
         "\n"
         "OPERATIONS\n"
         "    OR\n"
@@ -91,6 +100,9 @@ namespace {
         "INDEX RANGE\n"
         "    [0 - 5]\n"
         "\n"
+        "PRIORITY CLASSES\n"
+        "    system, foreground (default), background\n"
+        "\n"
         "EXAMPLE\n"
         "   OR 0\n"
         "\n"
@@ -98,6 +110,9 @@ namespace {
 
     constexpr std::string_view kInput = "input> ";
 
+    /// Maximal length of a line client is allowed to send
+    constexpr size_t kMaxLineSize = 1024;
+
     constexpr std::string_view kInvalidInput = "You have an error in your input, try again!\n";
 
     constexpr std::string_view kOutOfRange = "Provided index is out of allowed range!\n";
@@ -108,277 +123,1021 @@ namespace {
 
     constexpr std::string_view kProcessing = "Processing...\n";
 
+    constexpr std::string_view kDuplicate = "Request with such id is already being processed!\n";
+
+    constexpr std::string_view kUnknown = "Request with such id isn't being processed!\n";
+
+    constexpr std::string_view kTooMany = "Too many requests are being processed, try later!\n";
+
+    constexpr std::string_view kBusy = "Server is busy, try later!\n";
+
+    constexpr std::string_view kPriorityChanged = "Priority class changed!\n";
+
+    constexpr std::string_view kResultPrefix = "Result: ";
+
+    constexpr std::string_view kShortCircuitPrefix = "Short circuit: ";
+
+    /// Replies with results of boolean operations and known short
+    /// circuits, so they aren't built at runtime
+    constexpr std::string_view kResultFalse = "Result: false\n";
+
+    constexpr std::string_view kResultTrue = "Result: true\n";
+
+    constexpr std::string_view kShortCircuitFalse = "Short circuit: false\n";
+
+    constexpr std::string_view kShortCircuitTrue = "Short circuit: true\n";
+
+    constexpr std::string_view kShortCircuitZero = "Short circuit: 0\n";
+
+    /// Maximal amount of messages written by a single syscall
+    constexpr size_t kMaxGather = 64;
+
+    /// Maximal amount of pipelined requests processed simultaneously
+    constexpr size_t kMaxPipelined = 64;
+
+    /// Time client is given to send the first byte
+    /// before it is greeted as a human
+    constexpr std::chrono::milliseconds kNegotiationWindow{50};
+
+    /// Amount of output session stops reading requests at
+    /// until client receives it
+    constexpr size_t kMaxPendingOutput = 64 * 1024;
+
+    /**
+     * @brief Split pipelined request in the following format:
+     *  #<id><spaces[min:1]><request>
+     * @example
+     *  #17 OR 3
+     */
+    [[nodiscard]]
+    constexpr auto split_id(std::string_view str) noexcept -> std::optional<std::pair<std::string_view, std::string_view>>
+    {
+        if (str.empty() || str.front() != '#') {
+            return {};
+        }
+
+        str.remove_prefix(1);
+        const auto pos = str.find_first_of(" ");
+        const auto id = str.substr(0, pos);
+        if (id.empty()) {
+            return {};
+        }
+
+        str.remove_prefix(pos == std::string_view::npos ? str.size() : pos);
+        while (!str.empty() && str.front() == ' ') {
+            str.remove_prefix(1);
+        }
+
+        return std::pair{id, str};
+    }
+
+    /**
+     * @brief Parse priority class by its name.
+     */
+    [[nodiscard]]
+    constexpr auto parse_priority(const std::string_view str) noexcept -> std::optional<Priority>
+    {
+        if (str == "system") {
+            return Priority::System;
+        }
+        if (str == "foreground") {
+            return Priority::Foreground;
+        }
+        if (str == "background") {
+            return Priority::Background;
+        }
+        return {};
+    }
+
+    /**
+     * @brief Text of a reply without result.
+     */
+    [[nodiscard]]
+    constexpr auto message(const binary::Status status) noexcept -> std::string_view
+    {
+        switch (status) {
+        case binary::Status::Canceled:
+            return kCanceled;
+        case binary::Status::OutOfRange:
+            return kOutOfRange;
+        case binary::Status::Internal:
+            return kInternal;
+        case binary::Status::Invalid:
+            return kInvalidInput;
+        case binary::Status::Duplicate:
+            return kDuplicate;
+        case binary::Status::Unknown:
+            return kUnknown;
+        case binary::Status::TooMany:
+            return kTooMany;
+        case binary::Status::Busy:
+            return kBusy;
+        default:
+            return {};
+        }
+    }
+
+    /**
+     * @brief Text of a reply with result known at compile time.
+     * @return Empty string if reply must be built at runtime.
+     */
+    template<typename Op>
+    [[nodiscard]]
+    constexpr auto constant_reply(const binary::Status status, const typename Op::value_type value) noexcept -> std::string_view
+    {
+        const bool short_circuit = status == binary::Status::ShortCircuit;
+        if constexpr (std::is_same_v<typename Op::value_type, bool>) {
+            if (short_circuit) {
+                return value ? kShortCircuitTrue : kShortCircuitFalse;
+            }
+            return value ? kResultTrue : kResultFalse;
+        } else {
+            if (short_circuit && value == 0) {
+                return kShortCircuitZero;
+            }
+            return {};
+        }
+    }
+
+    static_assert(constant_reply<Or>(binary::Status::Result, true) == "Result: true\n");
+    static_assert(constant_reply<And>(binary::Status::ShortCircuit, false) == "Short circuit: false\n");
+
+    /**
+     * @brief Prefix reply to pipelined request with its @a id.
+     */
+    [[nodiscard]]
+    auto prefixed(const std::string_view id, const std::string_view message) -> std::string
+    {
+        std::string output;
+        if (!id.empty()) {
+            output.reserve(id.size() + message.size() + 2);
+            output += '#';
+            output += id;
+            output += ' ';
+        }
+        output += message;
+        return output;
+    }
+
 } // namespace
 
 
 Session::Session(boost::asio::io_context& context,
-                 boost::asio::ip::tcp::socket socket) :
+                 Backend& backend,
+                 boost::asio::ip::tcp::socket socket,
+                 Finished finished,
+                 Balancer* const balancer,
+                 const size_t loop,
+                 Cache* const cache,
+                 const Origin origin,
+                 Ring* const ring) :
     _context{context},
-    _socket{std::move(socket)}
-{ }
+    _backend{backend},
+    _socket{std::move(socket)},
+    _event{_context},
+    _finished{std::move(finished)},
+    _balancer{balancer},
+    _loop{loop},
+    _cache{cache},
+    _origin{origin},
+    _ring{ring}
+{
+    _buffer.reserve(kMaxLineSize);
+}
+
+Session::~Session() noexcept
+{
+    if (_finished) {
+        _finished();
+    }
+}
 
 void Session::start()
 {
-    auto self = shared_from_this();
-    boost::asio::spawn(
+    boost::asio::co_spawn(
         _context,
-        [this, self] (boost::asio::yield_context yield) {
-            boost::system::error_code ec;
+        [self = shared_from_this()] {
+            return self->_run(true);
+        },
+        boost::asio::detached
+    );
+}
+
+void Session::resume(std::string buffer, const bool binary)
+{
+    _buffer = std::move(buffer);
+    _binary = binary;
+    boost::asio::co_spawn(
+        _context,
+        [self = shared_from_this()] {
+            return self->_run(false);
+        },
+        boost::asio::detached
+    );
+}
 
-            /// Start from sending greeting message
-            boost::asio::async_write(
-                _socket,
-                boost::asio::buffer(kUsage),
-                yield[ec]
+void Session::stop()
+{
+    _stopping = true;
+    /// Wake up session waiting for request
+    _event.notify();
+}
+
+void Session::migrate(const size_t loop)
+{
+    /// Request has arrived meanwhile
+    if (!_waiting) {
+        _balancer->settle();
+        return;
+    }
+
+    _target = loop;
+    /// Wake up session waiting for request
+    _event.notify();
+}
+
+void Session::detach() noexcept
+{
+    _finished = nullptr;
+}
+
+auto Session::_run(const bool greet) -> boost::asio::awaitable<void>
+{
+    /// Machine clients announce themselves by the first byte
+    if (greet) {
+        _binary = co_await _negotiate();
+    }
+
+    Outcome outcome;
+    if (_binary) {
+        outcome = co_await _serve_binary();
+    } else {
+        outcome = co_await _serve_text(greet);
+    }
+
+    if (outcome == Outcome::Migrated) {
+        /// Client is served by another loop since now
+        co_return;
+    }
+
+    /// Nobody is going to receive results of abandoned requests
+    if (outcome == Outcome::Lost) {
+        for (const auto& [id, pipelined] : _pipelined) {
+            pipelined->canceled = true;
+            pipelined->event.notify();
+        }
+    }
+
+    /// Finish pipelined requests and deliver their results
+    while (!_pipelined.empty() || !_output.empty()) {
+        co_await _event.wait();
+    }
+
+    /// Complete pending read, so session can be released
+    if (_ring) {
+        /// Ring keeps reading socket until read is canceled
+        _abort_read();
+        while (_reading) {
+            co_await _event.wait();
+        }
+    }
+    boost::system::error_code ec;
+    _socket.close(ec);
+}
+
+auto Session::_negotiate() -> boost::asio::awaitable<bool>
+{
+    /// Text clients are greeted once they stay silent for a while
+    boost::asio::steady_timer timer{_context, kNegotiationWindow};
+    _negotiating = true;
+    timer.async_wait(
+        [this, self = shared_from_this()] (const auto ec) {
+            if (!ec && _negotiating) {
+                boost::system::error_code ignored;
+                _socket.cancel(ignored);
+            }
+        }
+    );
+
+    boost::system::error_code ec;
+    co_await _socket.async_wait(
+        boost::asio::ip::tcp::socket::wait_read,
+        boost::asio::redirect_error(boost::asio::use_awaitable, ec)
+    );
+    _negotiating = false;
+    timer.cancel();
+    if (ec) {
+        co_return false;
+    }
+
+    char byte = 0;
+    if (_socket.receive(boost::asio::buffer(&byte, 1), 0, ec) == 0 || ec) {
+        /// Failure is noticed by the first read
+        co_return false;
+    }
+
+    if (static_cast<uint8_t>(byte) == binary::kMagic) {
+        co_return true;
+    }
+
+    /// Byte belongs to the first text request
+    _buffer.push_back(byte);
+    co_return false;
+}
+
+auto Session::_serve_text(const bool greet) -> boost::asio::awaitable<Outcome>
+{
+    boost::system::error_code ec;
+
+    /// Start from sending greeting message
+    if (greet) {
+        _send(kUsage);
+    }
+
+    /// Start reading requests from client, migrated client is already asked
+    bool prompt = greet;
+    while (_socket.is_open() && !_stopping) {
+        /// Gently ask for input
+        if (std::exchange(prompt, true)) {
+            _send(kInput);
+        }
+
+        /// Don't accept requests from client who doesn't receive replies
+        while (_pending > kMaxPendingOutput && !_stopping) {
+            co_await _event.wait();
+        }
+
+        if (co_await _wait_input()) {
+            co_return Outcome::Migrated;
+        }
+
+        if (_stopping) {
+            break;
+        }
+
+        const auto request = _take_line(ec);
+        if (ec) {
+            co_return Outcome::Lost;
+        }
+
+        /// Pipelined requests are processed in background
+        if (_pipeline(request)) {
+            prompt = false;
+            continue;
+        }
+
+        if (_prioritize(request)) {
+            continue;
+        }
+
+        const std::string_view input{request};
+        const auto line = parse(input);
+        if (!line) {
+            if (!input.empty()) {
+                /// Send error message
+                _send(kInvalidInput);
+            }
+
+            /// Try again
+            continue;
+        }
+
+        /// Split into separate variables
+        const auto [operation, index] = *line;
+        if (_balancer) {
+            ++_activity;
+            _balancer->started(_loop);
+        }
+        co_await std::visit(
+            [this, index = index] (const auto operation) {
+                using Op = std::remove_const_t<decltype(operation)>;
+                return _compute<Op>(index, nullptr);
+            },
+            operation
+        );
+        if (_balancer) {
+            _balancer->finished(_loop);
+        }
+    }
+
+    co_return Outcome::Finished;
+}
+
+auto Session::_serve_binary() -> boost::asio::awaitable<Outcome>
+{
+    while (_socket.is_open() && !_stopping) {
+        /// Every request received completely is evaluated in background
+        std::string_view input{_buffer};
+        binary::Request request;
+        size_t consumed = 0;
+        auto decoded = binary::Decoded::Incomplete;
+        while ((decoded = binary::decode(input, request, consumed)) == binary::Decoded::Complete) {
+            input.remove_prefix(consumed);
+
+            /// Numeric id is short enough to be stored in place
+            const auto id = std::to_string(request.id);
+            if (request.operation) {
+                _start(id,
+                       request.id,
+                       *request.operation,
+                       request.index,
+                       request.priority.value_or(_origin.priority));
+            } else {
+                _cancel(id, request.id);
+            }
+        }
+        _buffer.erase(0, _buffer.size() - input.size());
+
+        if (decoded == binary::Decoded::Malformed) {
+            /// Frames can't be told apart anymore
+            _reply({}, 0, binary::Status::Invalid);
+            break;
+        }
+
+        /// Don't accept requests from client who doesn't receive replies
+        while (_pending > kMaxPendingOutput && !_stopping) {
+            co_await _event.wait();
+        }
+
+        if (co_await _wait_input()) {
+            co_return Outcome::Migrated;
+        }
+
+        if (_stopping) {
+            break;
+        }
+
+        const auto [ec, size] = *std::exchange(_received, std::nullopt);
+        if (ec) {
+            co_return Outcome::Lost;
+        }
+    }
+
+    co_return Outcome::Finished;
+}
+
+auto Session::_wait_input() -> boost::asio::awaitable<bool>
+{
+    /// Read request, unless it is already being read
+    _read();
+    if (_balancer && !_ready() && _pipelined.empty()) {
+        /// Session may be moved to another loop while waiting,
+        /// recent requests count less and less
+        const auto ticket = _balancer->wait(_loop, weak_from_this(), _activity);
+        _activity /= 2;
+        _waiting = true;
+        while (!_ready() && !_stopping && !_target) {
+            co_await _event.wait();
+        }
+        _waiting = false;
+        _balancer->leave(_loop, ticket);
+
+        if (_target) {
+            if (!_stopping && co_await _migrate()) {
+                co_return true;
+            }
+
+            /// Session stays here
+            _target.reset();
+            _balancer->settle();
+        }
+    }
+
+    while (!_ready() && !_stopping) {
+        co_await _event.wait();
+    }
+
+    co_return false;
+}
+
+auto Session::_migrate() -> boost::asio::awaitable<bool>
+{
+    const auto target = *std::exchange(_target, std::nullopt);
+
+    /// Deliver output first, since cancelation aborts writing
+    while (!_output.empty()) {
+        co_await _event.wait();
+    }
+
+    /// Stop reading, data received so far is kept in buffer
+    _abort_read();
+    while (_reading) {
+        co_await _event.wait();
+    }
+
+    if (_received && _received->first != boost::asio::error::operation_aborted) {
+        /// Request has arrived or connection is lost meanwhile
+        co_return false;
+    }
+    _received.reset();
+
+    boost::system::error_code ec;
+    const auto protocol = _socket.local_endpoint(ec).protocol();
+    if (ec) {
+        co_return false;
+    }
+
+    const auto fd = _socket.release(ec);
+    if (ec) {
+        co_return false;
+    }
+
+    _balancer->move(target, protocol, fd, std::move(_buffer), _binary);
+    co_return true;
+}
+
+bool Session::_pipeline(const std::string_view line)
+{
+    /// Cancelation of pipelined request
+    if (line.size() > 2 && line.substr(0, 2) == "q ") {
+        const auto parts = split_id(line.substr(2));
+        if (!parts || !parts->second.empty()) {
+            return false;
+        }
+
+        _cancel(parts->first, 0);
+        return true;
+    }
+
+    const auto parts = split_id(line);
+    if (!parts) {
+        return false;
+    }
+
+    const auto [id, rest] = *parts;
+    const auto request = parse(rest);
+    if (!request) {
+        _reply(id, 0, binary::Status::Invalid);
+        return true;
+    }
+
+    _start(id, 0, request->first, request->second, _origin.priority);
+    return true;
+}
+
+bool Session::_prioritize(const std::string_view line)
+{
+    constexpr std::string_view kCommand = "priority ";
+    if (line.substr(0, kCommand.size()) != kCommand) {
+        return false;
+    }
+
+    const auto priority = parse_priority(line.substr(kCommand.size()));
+    if (!priority) {
+        _send(kInvalidInput);
+        return true;
+    }
+
+    /// Requests being evaluated keep their class
+    _origin.priority = *priority;
+    _send(kPriorityChanged);
+    return true;
+}
+
+void Session::_start(const std::string_view id,
+                     const uint64_t number,
+                     const Operation& operation,
+                     const size_t index,
+                     const Priority priority)
+{
+    if (_pipelined.count(std::string{id}) != 0) {
+        _reply(id, number, binary::Status::Duplicate);
+        return;
+    }
+
+    if (_pipelined.size() >= kMaxPipelined) {
+        _reply(id, number, binary::Status::TooMany);
+        return;
+    }
+
+    auto pipelined = std::make_shared<Pipelined>(_context, std::string{id}, number, priority);
+    _pipelined.emplace(pipelined->id, pipelined);
+    if (_balancer) {
+        ++_activity;
+        _balancer->started(_loop);
+    }
+
+    boost::asio::co_spawn(
+        _context,
+        [self = shared_from_this(), pipelined = std::move(pipelined), operation, index] () -> boost::asio::awaitable<void> {
+            co_await std::visit(
+                [&] (const auto operation) {
+                    using Op = std::remove_const_t<decltype(operation)>;
+                    return self->_compute<Op>(index, pipelined.get());
+                },
+                operation
             );
 
-            /// Start reading requests from client
-            std::string buffer;
-            buffer.reserve(1024);
-            while (_socket.is_open()) {
-                /// Gently ask for input
-                boost::asio::async_write(
-                    _socket,
-                    boost::asio::buffer(kInput),
-                    yield[ec]
-                );
-
-                /// Read operation and index
-                /// Allow to read only small chunk of data otherwise
-                /// user is abusing us
-                const auto size = boost::asio::async_read_until(
-                    _socket,
-                    boost::asio::dynamic_buffer(buffer, buffer.capacity()),
-                    '\n',
-                    yield[ec]
-                );
+            self->_pipelined.erase(pipelined->id);
+            if (self->_balancer) {
+                self->_balancer->finished(self->_loop);
+            }
+            self->_event.notify();
+        },
+        boost::asio::detached
+    );
+}
+
+void Session::_cancel(const std::string_view id, const uint64_t number)
+{
+    const auto pipelined = _pipelined.find(std::string{id});
+    if (pipelined == _pipelined.end()) {
+        _reply(id, number, binary::Status::Unknown);
+        return;
+    }
+
+    pipelined->second->canceled = true;
+    pipelined->second->event.notify();
+}
+
+void Session::_reply(const std::string_view id, const uint64_t number, const binary::Status status)
+{
+    if (_binary) {
+        binary::Frame frame;
+        _send(std::string{binary::encode(status, number, frame)});
+    } else {
+        _send(id, message(status));
+    }
+}
+
+template<typename Op>
+void Session::_reply(const Pipelined* const pipelined,
+                     const binary::Status status,
+                     const std::optional<typename Op::value_type> value)
+{
+    const std::string_view id = pipelined ? std::string_view{pipelined->id} : std::string_view{};
+    const uint64_t number = pipelined ? pipelined->number : 0;
+    if (!value) {
+        _reply(id, number, status);
+        return;
+    }
+
+    if (_binary) {
+        binary::Frame frame;
+        _send(std::string{binary::encode(status, number, frame, value)});
+        return;
+    }
+
+    /// Most of results are known at compile time
+    const auto constant = constant_reply<Op>(status, *value);
+    if (!constant.empty()) {
+        _send(id, constant);
+        return;
+    }
+
+    const std::string_view prefix = status == binary::Status::ShortCircuit ? kShortCircuitPrefix : kResultPrefix;
+    _send(prefixed(id, std::string{prefix} + std::string{Op::serialize(*value)} + "\n"));
+}
+
+void Session::_send(const std::string_view message)
+{
+    if (!_socket.is_open()) {
+        return;
+    }
+
+    _pending += message.size();
+    _output.emplace_back(message);
+    _schedule();
+}
+
+void Session::_send(std::string message)
+{
+    if (!_socket.is_open()) {
+        return;
+    }
+
+    _pending += message.size();
+    _output.emplace_back(std::move(message));
+    _schedule();
+}
+
+void Session::_send(const std::string_view id, const std::string_view message)
+{
+    if (id.empty()) {
+        _send(message);
+    } else {
+        _send(prefixed(id, message));
+    }
+}
+
+void Session::_schedule()
+{
+    if (_writing || _scheduled) {
+        return;
+    }
+
+    _scheduled = true;
+    boost::asio::post(
+        _context,
+        [this, self = shared_from_this()] {
+            _scheduled = false;
+            _flush();
+        }
+    );
+}
+
+void Session::_flush()
+{
+    if (_writing || _output.empty()) {
+        return;
+    }
+
+    /// Only one write may be in progress, queued messages
+    /// stay in place until it is completed
+    _gather.clear();
+    for (const auto& output : _output) {
+        if (_gather.size() == kMaxGather) {
+            break;
+        }
+
+        std::visit(
+            [this] (const auto& message) {
+                _gather.push_back(boost::asio::buffer(message.data(), message.size()));
+            },
+            output
+        );
+    }
+
+    _writing = _gather.size();
+    auto handler = [this, self = shared_from_this()] (const auto ec, const auto size) {
+        const auto written = std::exchange(_writing, 0);
+        if (ec) {
+            /// Nobody receives the rest
+            _output.clear();
+            _pending = 0;
+        } else {
+            _output.erase(_output.begin(), _output.begin() + written);
+            _pending -= size;
+            /// Output queued meanwhile is written at once
+            _flush();
+        }
+        _event.notify();
+    };
+
+    if (_ring) {
+        std::vector<iovec> buffers;
+        buffers.reserve(_gather.size());
+        for (const auto& buffer : _gather) {
+            buffers.push_back({const_cast<void*>(buffer.data()), buffer.size()});
+        }
+
+        _ring->send(
+            _socket.native_handle(),
+            std::move(buffers),
+            [handler = std::move(handler)] (const int result) {
+                if (result < 0) {
+                    handler(boost::system::error_code{-result, boost::asio::error::get_system_category()}, 0);
+                } else {
+                    handler(boost::system::error_code{}, static_cast<size_t>(result));
+                }
+            }
+        );
+        return;
+    }
+
+    boost::asio::async_write(_socket, _gather, std::move(handler));
+}
+
+void Session::_read()
+{
+    if (_reading || _received) {
+        return;
+    }
+
+    auto handler = [this, self = shared_from_this()] (const auto ec, const auto size) {
+        _finish_read(ec, size);
+    };
 
+    /// Allow to read only small chunk of data otherwise
+    /// user is abusing us
+    _reading = true;
+    if (_ring) {
+        _receive(0);
+    } else if (_binary) {
+        boost::asio::async_read(
+            _socket,
+            boost::asio::dynamic_buffer(_buffer, kMaxLineSize),
+            boost::asio::transfer_at_least(1),
+            std::move(handler)
+        );
+    } else {
+        boost::asio::async_read_until(
+            _socket,
+            boost::asio::dynamic_buffer(_buffer, kMaxLineSize),
+            '\n',
+            std::move(handler)
+        );
+    }
+}
+
+void Session::_receive(const size_t searched)
+{
+    /// Line may be received along with the previous one
+    if (!_binary) {
+        if (const auto end = _buffer.find('\n', searched); end != std::string::npos) {
+            _finish_read({}, end + 1);
+            return;
+        }
+    }
+
+    if (_aborted) {
+        _finish_read(boost::asio::error::operation_aborted, 0);
+        return;
+    }
+
+    const auto size = _buffer.size();
+    if (size >= kMaxLineSize) {
+        _finish_read(_binary ? boost::system::error_code{} : boost::asio::error::not_found, 0);
+        return;
+    }
+
+    /// Reserved buffer isn't reallocated, so it stays in place until data is read
+    _buffer.resize(kMaxLineSize);
+    _read_id = _ring->read(
+        _socket.native_handle(),
+        _buffer.data() + size,
+        kMaxLineSize - size,
+        [this, self = shared_from_this(), size] (const int result) {
+            _buffer.resize(size + std::max(result, 0));
+            if (result == 0) {
+                _finish_read(boost::asio::error::eof, 0);
+            } else if (result < 0) {
+                _finish_read({-result, boost::asio::error::get_system_category()}, 0);
+            } else if (_binary) {
+                _finish_read({}, static_cast<size_t>(result));
+            } else {
+                _receive(size);
+            }
+        }
+    );
+}
+
+void Session::_finish_read(const boost::system::error_code& ec, const size_t size)
+{
+    _reading = false;
+    _aborted = false;
+    _received.emplace(ec, size);
+    _event.notify();
+}
+
+void Session::_abort_read()
+{
+    boost::system::error_code ec;
+    _socket.cancel(ec);
+    if (_ring && _reading) {
+        _aborted = true;
+        _ring->cancel(_read_id);
+    }
+}
+
+bool Session::_ready() const noexcept
+{
+    return _received.has_value();
+}
+
+auto Session::_take_line(boost::system::error_code& ec) -> std::string
+{
+    const auto [error, size] = *std::exchange(_received, std::nullopt);
+    ec = error;
+    if (ec) {
+        return {};
+    }
+
+    /// Strip delimiter
+    std::string line{_buffer.data(), size - 1};
+    _buffer.erase(0, size);
+    return line;
+}
+
+template<typename Op>
+auto Session::_compute(const size_t index, Pipelined* const pipelined) -> boost::asio::awaitable<void>
+{
+    /// Pipelined requests are woken up separately
+    auto& event = pipelined ? pipelined->event : _event;
+
+    /// Check whether index fit into bounds
+    if (index >= Op::kSize) {
+        _reply<Op>(pipelined, binary::Status::OutOfRange);
+        co_return;
+    }
+
+    /// Results of deterministic cases are evaluated once
+    if (_cache) {
+        if (const auto cached = _cache->get<Op>(index)) {
+            _reply<Op>(pipelined, cached->first, cached->second);
+            co_return;
+        }
+    }
+
+    /// Submit functions to execution
+    const auto priority = pipelined ? pipelined->priority : _origin.priority;
+    auto f = _submit<Op>(Function::F, index, priority, event);
+    auto g = _submit<Op>(Function::G, index, priority, event);
+    if (f.rejected() || g.rejected()) {
+        _reply<Op>(pipelined, binary::Status::Busy);
+        co_return;
+    }
+
+    /// Notify about started computation
+    if (!pipelined) {
+        _send(kProcessing);
+    }
+
+    while (_socket.is_open()) {
+        /// Check for short circuit or an error
+        for (const auto* result : {&f, &g}) {
+            if (!result->ready()) {
+                continue;
+            }
+
+            const auto& value = result->get();
+            if (!value) {
+                _reply<Op>(pipelined, binary::Status::Internal);
+                co_return;
+            }
+
+            if (Op::check_short_circuit(*value)) {
+                if (_cache) {
+                    _cache->put<Op>(index, binary::Status::ShortCircuit, Op::kShortCircuitResult);
+                }
+                _reply<Op>(pipelined, binary::Status::ShortCircuit, Op::kShortCircuitResult);
+                co_return;
+            }
+        }
+
+        if (f.ready() && g.ready()) {
+            const auto value = Op::compute(*f.get(), *g.get());
+            if (_cache) {
+                _cache->put<Op>(index, binary::Status::Result, value);
+            }
+            _reply<Op>(pipelined, binary::Status::Result, value);
+            co_return;
+        }
+
+        if (pipelined) {
+            if (pipelined->canceled) {
+                _reply<Op>(pipelined, binary::Status::Canceled);
+                co_return;
+            }
+        } else {
+            /// Client is allowed to cancel computation meanwhile
+            boost::system::error_code ec;
+            _read();
+            if (_ready()) {
+                const auto input = _take_line(ec);
                 if (ec) {
-                    return;
+                    /// Connection is lost or dumb user is abusing us
+                    co_return;
                 }
 
-                const std::string_view input{buffer.data(), size - 1};
-                const auto line = parse(input);
-                buffer.erase(0, size);
-                if (!line) {
-                    if (!input.empty()) {
-                        /// Send error message
-                        boost::asio::async_write(
-                            _socket,
-                            boost::asio::buffer(kInvalidInput),
-                            yield[ec]
-                        );
-                    }
-
-                    /// Try again
+                /// Pipelined requests are accepted meanwhile
+                if (_pipeline(input)) {
                     continue;
                 }
 
-                /// Split into separate variables
-                const auto [operation, index] = *line;
-                std::visit(
-                    [&, this, index = index] (const auto operation) {
-                        using Op = std::remove_const_t<decltype(operation)>;
-
-                        /// Check whether index fit into bounds
-                        if (index >= Op::kSize) {
-                            boost::asio::async_write(
-                                _socket,
-                                boost::asio::buffer(kOutOfRange),
-                                yield[ec]
-                            );
-
-                            /// Continue looping
-                            return;
-                        }
-
-                        /// Notify about started computation
-                        boost::asio::async_write(
-                            _socket,
-                            boost::asio::buffer(kProcessing),
-                            yield[ec]
-                        );
-
-                        /// Submit functions to execution
-                        auto f = _submit<Op, spos::lab1::demo::f_func<Op::kNativeOperation>>(index);
-                        auto g = _submit<Op, spos::lab1::demo::g_func<Op::kNativeOperation>>(index);
-
-                        /// Timer to periodically check for completion
-                        boost::asio::system_timer timer{_context};
-                        while (_socket.is_open()) {
-                            const auto ready = [&] (const auto& result) {
-                                return result.future().wait_for(std::chrono::seconds{0}) == std::future_status::ready;
-                            };
-
-                            /// Check for short circuit or an error
-                            const bool finished = std::apply(
-                                [&] (auto&... fs) {
-                                    return (
-                                        [&, this] (auto& f) {
-                                            if (!ready(f)) {
-                                                return false;
-                                            }
-
-                                            const auto& value = f.future().get();
-                                            if (!value) {
-                                                boost::asio::async_write(
-                                                    _socket,
-                                                    boost::asio::buffer(kInternal),
-                                                    yield[ec]
-                                                );
-                                                return true;
-                                            }
-
-                                            if (Op::check_short_circuit(*value)) {
-                                                const auto serialized = Op::serialize(Op::kShortCircuitResult);
-                                                const std::array result{boost::asio::buffer("Short circuit: "), boost::asio::buffer(serialized), boost::asio::buffer("\n")};
-                                                boost::asio::async_write(_socket, result, yield[ec]);
-                                                return true;
-                                            }
-
-                                            return false;
-                                        }(fs)
-                                        || ...
-                                    );
-                                },
-                                std::tie(f, g)
-                            );
-
-                            if (finished) {
-                                /// We are finished with computing
-                                return;
-                            }
-
-                            if (ready(f) && ready(g)) {
-                                const auto serialized = Op::serialize(Op::compute(*f.future().get(), *g.future().get()));
-                                const std::array result{boost::asio::buffer("Result: "), boost::asio::buffer(serialized), boost::asio::buffer("\n")};
-                                boost::asio::async_write(
-                                    _socket,
-                                    result,
-                                    yield[ec]
-                                );
-                                return;
-                            }
-
-                            /// Check how many bytes can we read
-                            if (_socket.available(ec) > 0 && !ec) {
-                                buffer.resize(2);
-                                const auto size = boost::asio::read(
-                                    _socket,
-                                    boost::asio::buffer(buffer, buffer.capacity()), 
-                                    ec
-                                );
-                                if (ec) {
-                                    /// Connection is lost or dumb user is abusing us
-                                    return;
-                                }
-
-                                const bool cancel = (size == 2 && std::string_view{buffer.data(), 2} == "q\n");
-                                buffer.clear();
-                                if (cancel) {
-                                    boost::asio::async_write(
-                                        _socket,
-                                        boost::asio::buffer(kCanceled),
-                                        yield[ec]
-                                    );
-                                    break;
-                                } else {
-                                    /// Some garbage was provided, read all available data
-                                    const auto size = boost::asio::async_read_until(
-                                        _socket,
-                                        boost::asio::dynamic_buffer(buffer, buffer.capacity()),
-                                        '\n',
-                                        yield[ec]
-                                    );
-                                    if (ec) {
-                                        /// Here we go again
-                                        return;
-                                    }
-
-                                    /// Send error message
-                                    boost::asio::async_write(
-                                        _socket,
-                                        boost::asio::buffer(kInvalidInput),
-                                        yield[ec]
-                                    );
-                                }
-                            }
-
-                            /// Wait to check value presence again
-                            timer.expires_from_now(std::chrono::milliseconds{1});
-                            timer.async_wait(yield[ec]);
-                        }
-                    },
-                    operation
-                );
+                if (input == "q") {
+                    _send(kCanceled);
+                    co_return;
+                }
+
+                /// Some garbage was provided, send error message
+                _send(kInvalidInput);
+                continue;
             }
         }
-    );
+
+        /// Wait until either result or client input arrives
+        co_await event.wait();
+    }
 }
 
-template<typename Op, auto F>
+template<typename Op>
 [[nodiscard]]
-auto Session::_submit(const size_t index) -> Result<typename Op::value_type>
-{
-    /// Pipe for communication with child
-    auto pipe = std::make_shared<boost::process::async_pipe>(_context);
-    /// Notify context that we are about to fork
-    _context.notify_fork(boost::asio::io_context::fork_prepare);
-
-    const auto pid = ::fork();
-    if (pid == 0) {
-        /// Notify io_context from child
-        _context.notify_fork(boost::asio::io_context::fork_child);
-        /// Close reading end of a pipe
-        std::move(*pipe).source().close();
-        /// Compute function
-        const auto result = (*F)(index);
-        /// Serialize result
-        const auto serialized = Op::serialize(result);
-        /// Write result to pipe
-        boost::system::error_code ec;
-        boost::asio::write(*pipe, boost::asio::buffer(serialized), ec);
-        if (ec) {
-            /// Exit with an error
-            std::exit(EX_SOFTWARE);
-        }
-        /// Exit successfully
-        std::exit(EX_OK);
-    } else if (pid < 0) {
-        /// Rare case that can happen when system has run out of resources
-        std::cerr << "Fork failed" << std::endl;
-        /// Panic
-        std::exit(EX_OSERR);
-    }
-
-    /// Notify io_context from parent
-    _context.notify_fork(boost::asio::io_context::fork_parent);
-    /// Close writing part of a pipe
-    std::move(*pipe).sink().close();
-    /// Promise to store value from async operation
-    std::promise<std::optional<typename Op::value_type>> promise;
-    /// Future function's result
-    auto future = promise.get_future();
-    /// Read result from a pipe
-    auto buffer = std::make_shared<std::string>();
-    boost::asio::async_read(
-        *pipe, 
-        boost::asio::dynamic_buffer(*buffer),
-        [promise = std::move(promise), pipe, buffer] (const auto ec, const auto) mutable {
-            if (ec != boost::asio::error::eof) {
-                return promise.set_value({});
-            }
+auto Session::_submit(const Function function,
+                      const size_t index,
+                      const Priority priority,
+                      Event& event) -> Result<typename Op::value_type>
+{
+    auto origin = _origin;
+    origin.priority = priority;
 
-            auto deserialized = Op::deserialize(*buffer);
-            if (!deserialized) {
-                return promise.set_value({});
+    /// Filled once function is evaluated
+    auto storage = std::make_shared<std::optional<std::optional<typename Op::value_type>>>();
+    /// Evaluate function using configured backend
+    auto task = _backend.submit(
+        {Op{}, function, index, origin},
+        [&event, storage] (const std::optional<int64_t> value) {
+            if (value) {
+                storage->emplace(static_cast<typename Op::value_type>(*value));
+            } else {
+                storage->emplace();
             }
 
-            promise.set_value(std::move(*deserialized));
+            event.notify();
         }
     );
 
-    return {pid, std::move(future), pipe};
+    return {std::move(task), std::move(storage)};
 }
 
 } // namespace lab1
@@ -1,86 +1,397 @@
 #pragma once
 
+#include <Lab1/Execution/Awaitable.hpp>
+#include <Lab1/Execution/Backend.hpp>
+#include <Lab1/Execution/Ring.hpp>
+#include <Lab1/Server/Balancer.hpp>
+#include <Lab1/Server/Binary.hpp>
+#include <Lab1/Server/Cache.hpp>
+#include <Lab1/Server/Event.hpp>
+
+#include <boost/asio/buffer.hpp>
 #include <boost/asio/ip/tcp.hpp>
-#include <boost/process/async_pipe.hpp>
+#include <boost/system/error_code.hpp>
 #include <cstddef>
-#include <future>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <optional>
-#include <unistd.h>
-#include <wait.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
 
 namespace lab1 {
 
 /**
  * @brief Single session with a user.
+ *
+ * Clients speak text protocol, unless the first byte they send is
+ * @a binary::kMagic: then requests and replies are binary frames
+ * and no greeting is sent.
  */
 class Session final: public std::enable_shared_from_this<Session>
 {
 public:
+    /**
+     * @brief Callback notified once session is finished.
+     */
+    using Finished = std::function<void()>;
+
     /**
      * @brief Construct session from already
      *  opened socket.
+     * @param finished Invoked on destruction.
+     * @param balancer Balancer allowed to move session to another
+     *  event loop, if any.
+     * @param loop Index of event loop in balancer.
+     * @param cache Cache of results, if any.
+     * @param origin Client functions are evaluated for.
+     * @param ring Ring socket is read and written by, reactor is used
+     *  otherwise.
      */
     Session(boost::asio::io_context& context,
-            boost::asio::ip::tcp::socket socket);
+            Backend& backend,
+            boost::asio::ip::tcp::socket socket,
+            Finished finished = {},
+            Balancer* balancer = nullptr,
+            size_t loop = 0,
+            Cache* cache = nullptr,
+            Origin origin = {},
+            Ring* ring = nullptr);
+
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+
+    ~Session() noexcept;
 
     /**
      * @brief Start serving client.
      */
     void start();
 
+    /**
+     * @brief Continue serving client moved from another event loop.
+     * @param buffer Data received from client, but not processed yet.
+     * @param binary Whether client speaks binary protocol.
+     */
+    void resume(std::string buffer, bool binary);
+
+    /**
+     * @brief Finish session once current request is served.
+     */
+    void stop();
+
+    /**
+     * @brief Move session to event @a loop, if it is still waiting
+     *  for request.
+     */
+    void migrate(size_t loop);
+
+    /**
+     * @brief Don't notify anybody on destruction.
+     */
+    void detach() noexcept;
+
 private:
     template<typename T>
     class Result
     {
     public:
-        using future_type = std::shared_future<std::optional<T>>;
-
-        Result(const pid_t pid, 
-               future_type future,
-               std::shared_ptr<boost::process::async_pipe> pipe) noexcept :
-            _pid{pid},
-            _future{std::move(future)},
-            _pipe{std::move(pipe)}
+        /**
+         * @brief Value of a function or empty optional on failure.
+         */
+        using value_type = std::optional<T>;
+
+        /**
+         * @brief Storage filled once function is evaluated.
+         */
+        using storage_type = std::shared_ptr<std::optional<value_type>>;
+
+        Result(std::unique_ptr<Backend::Task> task,
+               storage_type storage) noexcept :
+            _task{std::move(task)},
+            _storage{std::move(storage)}
         { }
 
-        ~Result() noexcept
+        /**
+         * @brief Check whether backend has rejected function.
+         */
+        [[nodiscard]]
+        bool rejected() const noexcept
         {
-            /// Terminate child process
-            ::kill(_pid, SIGKILL);
-            /// Collect its status code to omit orphans
-            int status;
-            ::waitpid(_pid, &status, 0);
-            /// Close pipe
-            boost::system::error_code ec;
-            _pipe->close(ec);
+            return !_task;
         }
 
         [[nodiscard]]
-        auto& future() noexcept
+        bool ready() const noexcept
         {
-            return _future;
+            return _storage->has_value();
         }
 
         [[nodiscard]]
-        const auto& future() const noexcept
+        const value_type& get() const noexcept
         {
-            return _future;
+            return **_storage;
         }
     
     private:
-        pid_t _pid;
-        future_type _future;
-        std::shared_ptr<boost::process::async_pipe> _pipe;
+        std::unique_ptr<Backend::Task> _task;
+        storage_type _storage;
+    };
+
+    /**
+     * @brief Request evaluated simultaneously with others,
+     *  identified by client.
+     */
+    struct Pipelined
+    {
+        Pipelined(boost::asio::io_context& context,
+                  std::string id,
+                  const uint64_t number,
+                  const Priority priority) :
+            id{std::move(id)},
+            number{number},
+            priority{priority},
+            event{context}
+        { }
+
+        const std::string id;
+        /// Id of request in binary protocol
+        const uint64_t number;
+        const Priority priority;
+        /// Wakes computation up once anything happens
+        Event event;
+        bool canceled = false;
     };
 
-    template<typename Op, auto F>
+    /**
+     * @brief Reason requests are no longer read.
+     */
+    enum class Outcome
+    {
+        /// Client is done or session is stopped
+        Finished,
+        /// Connection is lost
+        Lost,
+        /// Client is served by another loop
+        Migrated
+    };
+
+    /**
+     * @brief Serve requests until connection is closed.
+     * @param greet Whether session is new, so protocol
+     *  is negotiated first.
+     */
+    auto _run(bool greet) -> boost::asio::awaitable<void>;
+
+    /**
+     * @brief Wait shortly for the first byte sent by client.
+     * @return Whether client speaks binary protocol.
+     */
+    auto _negotiate() -> boost::asio::awaitable<bool>;
+
+    /**
+     * @brief Serve requests written as text lines.
+     * @param greet Whether to greet client first.
+     */
+    auto _serve_text(bool greet) -> boost::asio::awaitable<Outcome>;
+
+    /**
+     * @brief Serve requests encoded as binary frames.
+     */
+    auto _serve_binary() -> boost::asio::awaitable<Outcome>;
+
+    /**
+     * @brief Wait until data is read from client, session may be
+     *  moved to another loop meanwhile.
+     * @return Whether session is migrated.
+     */
+    auto _wait_input() -> boost::asio::awaitable<bool>;
+
+    /**
+     * @brief Hand connection over to event loop session is migrated to,
+     *  unless request arrives meanwhile.
+     * @return Whether connection is handed over.
+     */
+    auto _migrate() -> boost::asio::awaitable<bool>;
+
+    /**
+     * @brief Handle line of pipelined mode: start evaluation of request
+     *  with id or cancel one.
+     * @return Whether line belongs to pipelined mode.
+     */
+    bool _pipeline(std::string_view line);
+
+    /**
+     * @brief Handle line changing priority class of the following
+     *  requests.
+     * @return Whether line changes priority class.
+     */
+    bool _prioritize(std::string_view line);
+
+    /**
+     * @brief Start evaluation of pipelined request.
+     * @param number Id of request in binary protocol.
+     */
+    void _start(std::string_view id,
+                uint64_t number,
+                const Operation& operation,
+                size_t index,
+                Priority priority);
+
+    /**
+     * @brief Cancel evaluation of pipelined request.
+     */
+    void _cancel(std::string_view id, uint64_t number);
+
+    /**
+     * @brief Queue reply with @a status to pipelined request or
+     *  to the current one if @a id is empty, in client's protocol.
+     */
+    void _reply(std::string_view id, uint64_t number, binary::Status status);
+
+    /**
+     * @brief Queue reply with @a status and @a value to pipelined
+     *  request or to the current one if it is null.
+     */
+    template<typename Op>
+    void _reply(const Pipelined* pipelined,
+                binary::Status status,
+                std::optional<typename Op::value_type> value = {});
+
+    /**
+     * @brief Queue constant @a message to be sent to client.
+     * @note Message isn't copied, so it must never be destroyed.
+     */
+    void _send(std::string_view message);
+
+    /**
+     * @brief Queue @a message built at runtime to be sent to client.
+     */
+    void _send(std::string message);
+
+    /**
+     * @brief Queue reply to pipelined request @a id.
+     * @note Message is copied only if it is prefixed with id.
+     */
+    void _send(std::string_view id, std::string_view message);
+
+    /**
+     * @brief Write queued output at the end of current loop turn,
+     *  so everything produced by the turn is written at once.
+     */
+    void _schedule();
+
+    /**
+     * @brief Write all queued output by a single gathering write
+     *  unless it is being written already.
+     */
+    void _flush();
+
+    /**
+     * @brief Evaluate operation and report its result to client.
+     * @param pipelined Request evaluated in background, otherwise
+     *  client is allowed to cancel computation meanwhile.
+     */
+    template<typename Op>
+    auto _compute(size_t index, Pipelined* pipelined) -> boost::asio::awaitable<void>;
+
+    /**
+     * @brief Start reading next line from client, or any data
+     *  in binary protocol, unless it is already being read.
+     * @note Event is notified once data is read.
+     */
+    void _read();
+
+    /**
+     * @brief Read by ring until line is received, or any data
+     *  in binary protocol.
+     * @param searched Size of data received before, which holds
+     *  no delimiter.
+     */
+    void _receive(size_t searched);
+
+    /**
+     * @brief Finish reading with status @a ec and @a size of data read.
+     */
+    void _finish_read(const boost::system::error_code& ec, size_t size);
+
+    /**
+     * @brief Abort reading, data received so far is kept in buffer.
+     */
+    void _abort_read();
+
+    /**
+     * @brief Check whether data is read.
+     */
+    [[nodiscard]]
+    bool _ready() const noexcept;
+
+    /**
+     * @brief Take line read from client without delimiter.
+     * @param ec Set if line can't be read.
+     */
+    [[nodiscard]]
+    auto _take_line(boost::system::error_code& ec) -> std::string;
+
+    /**
+     * @brief Submit function to evaluation.
+     * @param event Notified once result is ready.
+     */
+    template<typename Op>
     [[nodiscard]]
-    auto _submit(size_t index) -> Result<typename Op::value_type>;
+    auto _submit(Function function, size_t index, Priority priority, Event& event) -> Result<typename Op::value_type>;
 
 private:
     boost::asio::io_context& _context;
+    Backend& _backend;
     boost::asio::ip::tcp::socket _socket;
+    /// Wakes session up once anything happens
+    Event _event;
+    /// Data received from client
+    std::string _buffer;
+    /// Whether client speaks binary protocol
+    bool _binary = false;
+    /// Whether protocol is being negotiated
+    bool _negotiating = false;
+    /// Whether data is being read
+    bool _reading = false;
+    /// Read submitted to ring
+    Ring::Id _read_id = 0;
+    /// Whether read submitted to ring is aborted
+    bool _aborted = false;
+    /// Status and size of data read
+    std::optional<std::pair<boost::system::error_code, size_t>> _received;
+    /// Output waiting to be sent, constant messages aren't copied
+    std::deque<std::variant<std::string_view, std::string>> _output;
+    /// Buffers of output being written
+    std::vector<boost::asio::const_buffer> _gather;
+    /// Amount of bytes waiting to be sent
+    size_t _pending = 0;
+    /// Amount of queued messages being written
+    size_t _writing = 0;
+    /// Whether output is going to be written at the end of loop turn
+    bool _scheduled = false;
+    /// Requests evaluated in background by id
+    std::unordered_map<std::string, std::shared_ptr<Pipelined>> _pipelined;
+    /// Whether session is asked to finish
+    bool _stopping = false;
+    Finished _finished;
+    Balancer* _balancer;
+    size_t _loop;
+    Cache* _cache;
+    Origin _origin;
+    Ring* _ring;
+    /// Event loop session is migrated to
+    std::optional<size_t> _target;
+    /// Whether session waits for request and may be migrated
+    bool _waiting = false;
+    /// Amount of requests sent recently, halved once session waits
+    size_t _activity = 0;
 };
 
 } // namespace lab1
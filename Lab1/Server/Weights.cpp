@@ -0,0 +1,104 @@
+#include <Lab1/Server/Weights.hpp>
+
+#include <algorithm>
+#include <boost/system/error_code.hpp>
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace lab1 {
+namespace {
+
+    /**
+     * @brief Check whether first @a prefix bits of @a lhs and @a rhs match.
+     */
+    template<typename Bytes>
+    [[nodiscard]]
+    bool match(const Bytes& lhs, const Bytes& rhs, const size_t prefix) noexcept
+    {
+        for (size_t i = 0; i < lhs.size() && i * 8 < prefix; ++i) {
+            const auto bits = std::min<size_t>(8, prefix - i * 8);
+            const auto mask = static_cast<unsigned char>(0xFF << (8 - bits));
+            if ((lhs[i] & mask) != (rhs[i] & mask)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Address of IPv4 client connected to IPv6 socket is mapped.
+     */
+    [[nodiscard]]
+    auto unmap(const boost::asio::ip::address& address) -> boost::asio::ip::address
+    {
+        if (address.is_v6() && address.to_v6().is_v4_mapped()) {
+            return boost::asio::ip::make_address_v4(boost::asio::ip::v4_mapped, address.to_v6());
+        }
+        return address;
+    }
+
+    [[nodiscard]]
+    auto parse_number(const std::string_view str, const std::string_view rule) -> size_t
+    {
+        size_t value = 0;
+        const auto [end, ec] = std::from_chars(str.begin(), str.end(), value);
+        if (ec != std::errc{} || end != str.end()) {
+            throw std::invalid_argument{"Malformed weight rule: " + std::string{rule}};
+        }
+        return value;
+    }
+
+} // namespace
+
+void Weights::add(const std::string_view rule)
+{
+    const auto slash = rule.find('/');
+    const auto equals = rule.find('=');
+    if (slash == std::string_view::npos || equals == std::string_view::npos || equals < slash) {
+        throw std::invalid_argument{"Malformed weight rule: " + std::string{rule}};
+    }
+
+    boost::system::error_code ec;
+    const auto network = unmap(boost::asio::ip::make_address(std::string{rule.substr(0, slash)}, ec));
+    if (ec) {
+        throw std::invalid_argument{"Malformed address in weight rule: " + std::string{rule}};
+    }
+
+    const auto prefix = parse_number(rule.substr(slash + 1, equals - slash - 1), rule);
+    const auto weight = parse_number(rule.substr(equals + 1), rule);
+    if (prefix > (network.is_v4() ? 32 : 128) || weight == 0) {
+        throw std::invalid_argument{"Weight rule out of range: " + std::string{rule}};
+    }
+
+    const auto position = std::find_if(
+        _rules.begin(),
+        _rules.end(),
+        [&] (const Rule& other) {
+            return other.prefix < prefix;
+        }
+    );
+    _rules.insert(position, Rule{network, prefix, weight});
+}
+
+auto Weights::weight(const boost::asio::ip::address& address) const noexcept -> size_t
+{
+    const auto client = unmap(address);
+    for (const auto& rule : _rules) {
+        if (rule.network.is_v4() && client.is_v4()) {
+            if (match(rule.network.to_v4().to_bytes(), client.to_v4().to_bytes(), rule.prefix)) {
+                return rule.weight;
+            }
+        } else if (rule.network.is_v6() && client.is_v6()) {
+            if (match(rule.network.to_v6().to_bytes(), client.to_v6().to_bytes(), rule.prefix)) {
+                return rule.weight;
+            }
+        }
+    }
+
+    return kDefaultWeight;
+}
+
+} // namespace lab1
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <boost/asio/ip/address.hpp>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace lab1 {
+
+/**
+ * @brief Shares of evaluations clients are entitled to by their subnet.
+ */
+class Weights
+{
+public:
+    /**
+     * @brief Weight of clients not covered by any rule.
+     */
+    static constexpr size_t kDefaultWeight = 1;
+
+    /**
+     * @brief Add rule in the following format:
+     *  <address>/<prefix>=<weight>
+     * @example
+     *  10.0.0.0/8=4
+     * @throw std::invalid_argument If rule is malformed.
+     */
+    void add(std::string_view rule);
+
+    /**
+     * @brief Weight of a client with @a address given by the rule
+     *  with the longest matching prefix.
+     */
+    [[nodiscard]]
+    auto weight(const boost::asio::ip::address& address) const noexcept -> size_t;
+
+private:
+    struct Rule
+    {
+        boost::asio::ip::address network;
+        size_t prefix;
+        size_t weight;
+    };
+
+    /// Rules, the longest prefix first
+    std::vector<Rule> _rules;
+};
+
+} // namespace lab1
@@ -1,19 +1,96 @@
+#include <Lab1/Execution/Admission.hpp>
+#include <Lab1/Execution/Coalescer.hpp>
+#include <Lab1/Execution/Placement.hpp>
+#include <Lab1/Execution/ProcessBackend.hpp>
+#include <Lab1/Execution/Profile.hpp>
+#include <Lab1/Execution/Reaper.hpp>
+#include <Lab1/Execution/Results.hpp>
+#include <Lab1/Execution/Ring.hpp>
+#include <Lab1/Execution/Spawner.hpp>
+#include <Lab1/Execution/ThreadPool.hpp>
+#include <Lab1/Execution/WorkerPool.hpp>
+#include <Lab1/Execution/Zygote.hpp>
+#include <Lab1/Server/Balancer.hpp>
+#include <Lab1/Server/Cache.hpp>
 #include <Lab1/Server/Server.hpp>
+#include <Lab1/Server/Weights.hpp>
 
 #include <Lab1/3rdparty/lyra/lyra.hpp>
 
-#include <boost/asio/executor_work_guard.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/address.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/signal_set.hpp>
 #include <csignal>
 #include <exception>
+#include <filesystem>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    /**
+     * @brief Event loop serving its own share of connections.
+     */
+    struct Loop
+    {
+        /// Loop is run by a single thread
+        boost::asio::io_context context{1};
+        /// Reads, writes and waits submitted by the loop, if it runs on io_uring
+        std::optional<lab1::Ring> ring;
+        std::unique_ptr<lab1::Spawner> spawner;
+        /// Keeps children on cores of the loop
+        std::optional<lab1::PinnedSpawner> pinned;
+        std::unique_ptr<lab1::Backend> backend;
+        /// Holds evaluation until it is admitted
+        std::optional<lab1::AdmissionBackend> admission;
+        /// Shares evaluation between identical requests
+        std::optional<lab1::Coalescer> coalescer;
+        std::optional<lab1::Server> server;
+    };
+
+    /**
+     * @brief Pin calling thread to @a core.
+     */
+    void pin(const int core) noexcept
+    {
+        if (!lab1::pin(0, {core})) {
+            std::cerr << "Can't pin event loop to core " << core << std::endl;
+        }
+    }
+
+} // namespace
 
 int main(int argc, char** argv)
 {
     uint16_t port = 20'003;
     std::string host = "127.0.0.1";
+    std::string backend = "zygote";
+    std::string reap = "sigchld";
+    size_t threads = 1;
+    size_t balance_threshold = 2;
+    size_t workers = 0;
+    size_t cache_size = 0;
+    size_t result_slots = 1024;
+    std::string result_channel = "memory";
+    std::string reactor = "epoll";
+    size_t max_evaluations = 0;
+    size_t max_queued = 1024;
+    size_t aging = lab1::Admission::kDefaultAging.count();
+    std::vector<std::string> weight_rules;
+    std::vector<std::string> profile_rules;
+    std::string loop_cores;
+    std::string child_cores;
+    /// Each request evaluates two functions simultaneously
+    size_t evaluation_threads = 0;
+    std::string worker_executable = (std::filesystem::read_symlink("/proc/self/exe").parent_path() / "lab1worker").string();
     bool show_help = false;
 
     auto cli
@@ -23,6 +100,64 @@ int main(int argc, char** argv)
         | lyra::opt(host, "host")
             ["-l"]["--listen"]
             ("Address to listen to [default: 127.0.0.1]")
+        | lyra::opt(threads, "amount")
+            ["-t"]["--threads"]
+            ("Amount of event loops, each pinned to its own core with its own acceptor [default: 1]")
+        | lyra::opt(loop_cores, "cores")
+            ["--loop-cores"]
+            ("Cores reserved for event loops, which take turns on them, e.g. 0-1 [default: any, every event loop on its own core if there are several]")
+        | lyra::opt(child_cores, "cores")
+            ["--child-cores"]
+            ("Cores functions are evaluated on, kept on NUMA node of their event loop unless there is a single unpinned one, e.g. 2-7,10 [default: the rest of cores if --loop-cores is set, any otherwise]")
+        | lyra::opt(balance_threshold, "requests")
+            ["--balance-threshold"]
+            ("Move waiting sessions from the busiest event loop to the idlest one once amount of requests they serve differs by more, 0 disables [default: 2]")
+        | lyra::opt(reactor, "kind")
+            ["--reactor"]
+            ("Way event loops do I/O of sockets, pipes and children: epoll readiness or io_uring submissions [default: epoll]")
+            .choices("epoll", "io_uring")
+        | lyra::opt(backend, "backend")
+            ["-b"]["--backend"]
+            ("Way of evaluating functions: fork, zygote, clone, spawn child processes or threads of the server [default: zygote]")
+            .choices("fork", "zygote", "clone", "spawn", "threads")
+        | lyra::opt(evaluation_threads, "amount")
+            ["--evaluation-threads"]
+            ("Amount of threads evaluating functions by threads backend, divided between event loops [default: twice amount of cores or event loops]")
+        | lyra::opt(reap, "method")
+            ["--reap"]
+            ("Way of collecting finished children: sigchld, pidfd [default: sigchld]")
+            .choices("sigchld", "pidfd")
+        | lyra::opt(result_slots, "amount")
+            ["--result-slots"]
+            ("Slots of shared memory children of every event loop write results to, the rest write to pipes, 0 disables [default: 1024]")
+        | lyra::opt(result_channel, "kind")
+            ["--result-channel"]
+            ("Channel children owning slots deliver results by: memory signalled by eventfd or a single pipe of every event loop [default: memory]")
+            .choices("memory", "pipe")
+        | lyra::opt(workers, "amount")
+            ["-w"]["--workers"]
+            ("Evaluate functions by a pool of long-lived worker processes instead, divided between event loops [default: 0]")
+        | lyra::opt(max_evaluations, "amount")
+            ["--max-evaluations"]
+            ("Maximal amount of functions evaluated simultaneously by all event loops, 0 disables [default: 0]")
+        | lyra::opt(max_queued, "amount")
+            ["--max-queued"]
+            ("Maximal amount of functions waiting for evaluation once limit is reached, the rest are rejected [default: 1024]")
+        | lyra::opt(aging, "milliseconds")
+            ["--aging"]
+            ("Time a function waits for evaluation before its priority class is promoted by one, 0 disables [default: 2000]")
+        | lyra::opt(weight_rules, "subnet=weight")
+            ["--weight"]
+            ("Share of evaluations clients of a subnet are entitled to once evaluations are limited, e.g. 10.0.0.0/8=4 [default: 1 for everybody]")
+        | lyra::opt(profile_rules, "class=attribute:value,...")
+            ["--profile"]
+            ("Scheduling of children evaluating requests of a priority class, attributes are nice, policy (other, batch, idle), io (realtime, best-effort, idle), cpu (seconds), memory (bytes) [default: background=nice:19,policy:idle,io:idle]")
+        | lyra::opt(cache_size, "entries")
+            ["--cache"]
+            ("Remember results of this many most recently requested cases shared by event loops, 0 disables [default: 0]")
+        | lyra::opt(worker_executable, "path")
+            ["--worker-executable"]
+            ("Path to worker executable [default: lab1worker next to server]")
         | lyra::help(show_help)
             ("Show help message");
     
@@ -37,24 +172,212 @@ int main(int argc, char** argv)
         return 0;
     }
 
+    /// Allow as many simultaneous connections as system permits
+    if (rlimit limit; ::getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
     try {
-        boost::asio::io_context context;
-        lab1::Server server{context, boost::asio::ip::make_address(host), port};
-        boost::asio::signal_set signal_set{context, SIGTERM};
-        auto work_guard = boost::asio::make_work_guard(context);
+        /// Children are scheduled by class of their requests,
+        /// profiles are copied by helper process
+        lab1::Profiles profiles;
+        for (const auto& rule : profile_rules) {
+            profiles.add(rule);
+        }
+
+        /// Event loops and evaluations don't share cores,
+        /// several loops run on their own cores anyway
+        threads = std::max<size_t>(1, threads);
+        const lab1::Placement placement{lab1::parse_cores(loop_cores), lab1::parse_cores(child_cores), threads > 1};
+
+        /// Slots of every loop must be inherited by helper process
+        std::vector<std::unique_ptr<lab1::Results>> results;
+        std::vector<lab1::Results*> shared;
+        if (workers == 0 && backend != "threads" && result_slots > 0) {
+            const auto channel = result_channel == "pipe" ? lab1::Results::Channel::Pipe : lab1::Results::Channel::Memory;
+            for (size_t i = 0; i < threads; ++i) {
+                shared.push_back(results.emplace_back(std::make_unique<lab1::Results>(result_slots, channel)).get());
+            }
+        }
+
+        /// Helper process must be forked while server is still tiny,
+        /// every loop talks to it over a channel of its own
+        std::optional<lab1::Zygote> zygote;
+        if (backend == "zygote" && workers == 0) {
+            zygote.emplace(&profiles, shared, threads);
+        }
+
+        if (evaluation_threads == 0) {
+            evaluation_threads = 2 * std::max<size_t>(std::thread::hardware_concurrency(), threads);
+        }
+        /// Sessions are moved between loops, if there are several
+        std::optional<lab1::Balancer> balancer;
+        if (threads > 1 && balance_threshold > 0) {
+            balancer.emplace(balance_threshold);
+        }
+
+        /// Children of all loops are limited together
+        std::optional<lab1::Admission> admission;
+        if (max_evaluations > 0) {
+            admission.emplace(max_evaluations, max_queued, std::chrono::milliseconds{aging});
+        }
+
+        /// Clients of every subnet are weighted the same way by every loop
+        lab1::Weights weights;
+        for (const auto& rule : weight_rules) {
+            weights.add(rule);
+        }
+
+        /// Results of cases are the same on every loop
+        std::optional<lab1::Cache> cache;
+        if (cache_size > 0) {
+            cache.emplace(cache_size);
+        }
+
+        std::vector<std::unique_ptr<Loop>> loops;
+        for (size_t i = 0; i < threads; ++i) {
+            loops.push_back(std::make_unique<Loop>());
+        }
+        /// Signals are listened to by the first loop
+        auto& context = loops.front()->context;
+
+        /// Single collector of all children, waiting for SIGCHLD
+        std::optional<lab1::Reaper> reaper;
+        if (reap == "sigchld") {
+            reaper.emplace(context);
+        }
+
+        for (size_t i = 0; i < loops.size(); ++i) {
+            auto& loop = loops[i];
+            const auto cores = placement.children(i);
+            if (reactor == "io_uring") {
+                loop->ring.emplace(loop->context);
+            }
+            if (backend == "fork") {
+                loop->spawner = std::make_unique<lab1::ForkSpawner>(loop->context, &profiles);
+            } else if (backend == "clone") {
+                loop->spawner = std::make_unique<lab1::CloneSpawner>(worker_executable, &profiles);
+            } else if (backend == "spawn") {
+                loop->spawner = std::make_unique<lab1::PosixSpawner>(worker_executable, &profiles);
+            } else if (zygote) {
+                loop->spawner = std::make_unique<lab1::ZygoteSpawner>(loop->context, *zygote, i);
+            }
+
+            /// Pools are divided between loops
+            if (workers > 0) {
+                loop->backend = std::make_unique<lab1::WorkerPool>(loop->context, worker_executable, std::max<size_t>(1, workers / threads), cores);
+            } else if (backend == "threads") {
+                loop->backend = std::make_unique<lab1::ThreadPool>(loop->context, std::max<size_t>(1, evaluation_threads / threads), cores);
+            } else {
+                auto& spawner = *loop->spawner;
+                if (!cores.empty()) {
+                    loop->pinned.emplace(spawner, cores);
+                }
+                loop->backend = std::make_unique<lab1::ProcessBackend>(
+                    loop->context,
+                    loop->pinned ? static_cast<lab1::Spawner&>(*loop->pinned) : spawner,
+                    reaper ? &*reaper : nullptr,
+                    results.empty() ? nullptr : results[i].get(),
+                    loop->ring ? &*loop->ring : nullptr
+                );
+            }
+
+            if (admission) {
+                loop->admission.emplace(loop->context, *loop->backend, *admission);
+            }
+            loop->coalescer.emplace(loop->admission ? static_cast<lab1::Backend&>(*loop->admission) : *loop->backend);
+
+            /// Kernel balances connections between acceptors of all loops
+            loop->server.emplace(
+                loop->context,
+                *loop->coalescer,
+                boost::asio::ip::make_address(host),
+                port,
+                threads > 1,
+                balancer ? &*balancer : nullptr,
+                cache ? &*cache : nullptr,
+                &weights,
+                loop->ring ? &*loop->ring : nullptr
+            );
+        }
+
+        /// Loops are stopped together once every one of them is finished,
+        /// since children of all of them are collected by the first one
+        std::atomic<size_t> running{loops.size()};
+        const auto stop_all = [&] {
+            for (auto& loop : loops) {
+                loop->context.stop();
+            }
+        };
 
         /// Asyncrhonously listen to termination signal
+        boost::asio::signal_set signal_set{context, SIGTERM};
         signal_set.async_wait(
             [&] (const auto /*ec*/, const int /*sig*/) {
                 signal_set.cancel();
-                server.stop();
-                work_guard.reset();
+                for (auto& loop : loops) {
+                    boost::asio::post(loop->context, [&, &server = *loop->server] {
+                        server.stop([&] {
+                            if (running.fetch_sub(1) == 1) {
+                                stop_all();
+                            }
+                        });
+                    });
+                }
             }
         );
-        /// Start server
-        server.start();
-        /// Start main event loop
-        context.run();
+        if (reaper) {
+            reaper->start();
+        }
+
+        const auto run = [&] (const size_t index) {
+            if (const auto core = placement.loop(index)) {
+                pin(*core);
+            }
+
+            auto& loop = *loops[index];
+            /// Start server
+            loop.server->start();
+            /// Start event loop
+            loop.context.run();
+        };
+
+        std::vector<std::thread> loop_threads;
+        std::atomic<bool> failed{false};
+        for (size_t i = 1; i < loops.size(); ++i) {
+            loop_threads.emplace_back([&, i] {
+                try {
+                    run(i);
+                } catch (const std::exception& e) {
+                    std::cerr << "Event loop failed with error: " << e.what() << std::endl;
+                    failed = true;
+                    stop_all();
+                }
+            });
+        }
+
+        try {
+            run(0);
+        } catch (...) {
+            stop_all();
+            for (auto& thread : loop_threads) {
+                thread.join();
+            }
+            throw;
+        }
+
+        for (auto& thread : loop_threads) {
+            thread.join();
+        }
+
+        if (cache) {
+            std::cout << "Cache hits: " << cache->hits() << ", misses: " << cache->misses() << std::endl;
+        }
+
+        if (failed) {
+            return 1;
+        }
     } catch(const std::exception& e) {
         std::cerr << "Application failed with error: " << e.what() << std::endl;
         return 1;
@@ -0,0 +1,86 @@
+#include <Lab1/Execution/Results.hpp>
+#include <Lab1/Execution/Worker.hpp>
+
+#include <Lab1/3rdparty/lyra/lyra.hpp>
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <sysexits.h>
+#include <unistd.h>
+
+int main(int argc, char** argv)
+{
+    int fd = -1;
+    int operation = -1;
+    int function = -1;
+    int index = -1;
+    int results_fd = -1;
+    int event_fd = -1;
+    uint64_t tag = 0;
+    bool show_help = false;
+
+    auto cli
+        = lyra::opt(fd, "fd")
+            ["--fd"]
+            ("Descriptor of a channel connected to the server")
+        | lyra::opt(operation, "operation")
+            ["--operation"]
+            ("Evaluate single job of operation and write result to standard output")
+        | lyra::opt(function, "function")
+            ["--function"]
+            ("Function of a single job")
+        | lyra::opt(index, "index")
+            ["--index"]
+            ("Index of a single job")
+        | lyra::opt(event_fd, "fd")
+            ["--event-fd"]
+            ("Descriptor of a pipe raw result of a single job is written to instead of standard output, or of eventfd signalled once it is written to shared memory")
+        | lyra::opt(tag, "tag")
+            ["--tag"]
+            ("Tag of a slot result belongs to")
+        | lyra::opt(results_fd, "fd")
+            ["--results-fd"]
+            ("Descriptor of shared memory result is written to")
+        | lyra::help(show_help)
+            ("Show help message");
+
+    auto result = cli.parse({argc, argv});
+    if (!result) {
+        std::cerr << "Error in command line: " << result.errorMessage() << std::endl;
+        return EX_USAGE;
+    }
+
+    if (show_help) {
+        std::cout << cli << std::endl;
+        return 0;
+    }
+
+    try {
+        if (fd < 0) {
+            /// One-shot mode
+            const auto job = lab1::unpack({
+                static_cast<uint8_t>(operation),
+                static_cast<uint8_t>(function),
+                static_cast<uint32_t>(index)
+            });
+            if (!job) {
+                std::cerr << "Invalid job" << std::endl;
+                return EX_USAGE;
+            }
+
+            if (event_fd >= 0) {
+                const auto value = lab1::evaluate_value(*job);
+                return lab1::publish(results_fd, event_fd, tag, value) ? EX_OK : EX_SOFTWARE;
+            }
+
+            return lab1::evaluate(*job, STDOUT_FILENO) ? EX_OK : EX_SOFTWARE;
+        }
+
+        lab1::Worker worker{fd};
+        return worker.run();
+    } catch(const std::exception& e) {
+        std::cerr << "Worker failed with error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lab1.dir/main.cpp.o"
+  "CMakeFiles/lab1.dir/main.cpp.o.d"
+  "lab1"
+  "lab1.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/lab1.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lab1connbench.dir/Benchmarks/connections.cpp.o"
+  "CMakeFiles/lab1connbench.dir/Benchmarks/connections.cpp.o.d"
+  "lab1connbench"
+  "lab1connbench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/lab1connbench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,38 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/Lab1/Execution/Admission.cpp" "Lab1/CMakeFiles/lab1core.dir/Execution/Admission.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Execution/Admission.cpp.o.d"
+  "/root/repo/Lab1/Execution/Coalescer.cpp" "Lab1/CMakeFiles/lab1core.dir/Execution/Coalescer.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Execution/Coalescer.cpp.o.d"
+  "/root/repo/Lab1/Execution/Job.cpp" "Lab1/CMakeFiles/lab1core.dir/Execution/Job.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Execution/Job.cpp.o.d"
+  "/root/repo/Lab1/Execution/Placement.cpp" "Lab1/CMakeFiles/lab1core.dir/Execution/Placement.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Execution/Placement.cpp.o.d"
+  "/root/repo/Lab1/Execution/ProcessBackend.cpp" "Lab1/CMakeFiles/lab1core.dir/Execution/ProcessBackend.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Execution/ProcessBackend.cpp.o.d"
+  "/root/repo/Lab1/Execution/Profile.cpp" "Lab1/CMakeFiles/lab1core.dir/Execution/Profile.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Execution/Profile.cpp.o.d"
+  "/root/repo/Lab1/Execution/Reaper.cpp" "Lab1/CMakeFiles/lab1core.dir/Execution/Reaper.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Execution/Reaper.cpp.o.d"
+  "/root/repo/Lab1/Execution/Results.cpp" "Lab1/CMakeFiles/lab1core.dir/Execution/Results.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Execution/Results.cpp.o.d"
+  "/root/repo/Lab1/Execution/Ring.cpp" "Lab1/CMakeFiles/lab1core.dir/Execution/Ring.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Execution/Ring.cpp.o.d"
+  "/root/repo/Lab1/Execution/Spawner.cpp" "Lab1/CMakeFiles/lab1core.dir/Execution/Spawner.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Execution/Spawner.cpp.o.d"
+  "/root/repo/Lab1/Execution/ThreadPool.cpp" "Lab1/CMakeFiles/lab1core.dir/Execution/ThreadPool.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Execution/ThreadPool.cpp.o.d"
+  "/root/repo/Lab1/Execution/Worker.cpp" "Lab1/CMakeFiles/lab1core.dir/Execution/Worker.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Execution/Worker.cpp.o.d"
+  "/root/repo/Lab1/Execution/WorkerPool.cpp" "Lab1/CMakeFiles/lab1core.dir/Execution/WorkerPool.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Execution/WorkerPool.cpp.o.d"
+  "/root/repo/Lab1/Execution/Zygote.cpp" "Lab1/CMakeFiles/lab1core.dir/Execution/Zygote.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Execution/Zygote.cpp.o.d"
+  "/root/repo/Lab1/Server/Balancer.cpp" "Lab1/CMakeFiles/lab1core.dir/Server/Balancer.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Server/Balancer.cpp.o.d"
+  "/root/repo/Lab1/Server/Cache.cpp" "Lab1/CMakeFiles/lab1core.dir/Server/Cache.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Server/Cache.cpp.o.d"
+  "/root/repo/Lab1/Server/Event.cpp" "Lab1/CMakeFiles/lab1core.dir/Server/Event.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Server/Event.cpp.o.d"
+  "/root/repo/Lab1/Server/Server.cpp" "Lab1/CMakeFiles/lab1core.dir/Server/Server.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Server/Server.cpp.o.d"
+  "/root/repo/Lab1/Server/Session.cpp" "Lab1/CMakeFiles/lab1core.dir/Server/Session.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Server/Session.cpp.o.d"
+  "/root/repo/Lab1/Server/Weights.cpp" "Lab1/CMakeFiles/lab1core.dir/Server/Weights.cpp.o" "gcc" "Lab1/CMakeFiles/lab1core.dir/Server/Weights.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
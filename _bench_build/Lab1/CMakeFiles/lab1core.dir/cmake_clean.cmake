@@ -0,0 +1,49 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lab1core.dir/Execution/Admission.cpp.o"
+  "CMakeFiles/lab1core.dir/Execution/Admission.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Execution/Coalescer.cpp.o"
+  "CMakeFiles/lab1core.dir/Execution/Coalescer.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Execution/Job.cpp.o"
+  "CMakeFiles/lab1core.dir/Execution/Job.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Execution/Placement.cpp.o"
+  "CMakeFiles/lab1core.dir/Execution/Placement.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Execution/ProcessBackend.cpp.o"
+  "CMakeFiles/lab1core.dir/Execution/ProcessBackend.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Execution/Profile.cpp.o"
+  "CMakeFiles/lab1core.dir/Execution/Profile.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Execution/Reaper.cpp.o"
+  "CMakeFiles/lab1core.dir/Execution/Reaper.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Execution/Results.cpp.o"
+  "CMakeFiles/lab1core.dir/Execution/Results.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Execution/Ring.cpp.o"
+  "CMakeFiles/lab1core.dir/Execution/Ring.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Execution/Spawner.cpp.o"
+  "CMakeFiles/lab1core.dir/Execution/Spawner.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Execution/ThreadPool.cpp.o"
+  "CMakeFiles/lab1core.dir/Execution/ThreadPool.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Execution/Worker.cpp.o"
+  "CMakeFiles/lab1core.dir/Execution/Worker.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Execution/WorkerPool.cpp.o"
+  "CMakeFiles/lab1core.dir/Execution/WorkerPool.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Execution/Zygote.cpp.o"
+  "CMakeFiles/lab1core.dir/Execution/Zygote.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Server/Balancer.cpp.o"
+  "CMakeFiles/lab1core.dir/Server/Balancer.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Server/Cache.cpp.o"
+  "CMakeFiles/lab1core.dir/Server/Cache.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Server/Event.cpp.o"
+  "CMakeFiles/lab1core.dir/Server/Event.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Server/Server.cpp.o"
+  "CMakeFiles/lab1core.dir/Server/Server.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Server/Session.cpp.o"
+  "CMakeFiles/lab1core.dir/Server/Session.cpp.o.d"
+  "CMakeFiles/lab1core.dir/Server/Weights.cpp.o"
+  "CMakeFiles/lab1core.dir/Server/Weights.cpp.o.d"
+  "liblab1core.a"
+  "liblab1core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/lab1core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lab1reactorbench.dir/Benchmarks/reactor.cpp.o"
+  "CMakeFiles/lab1reactorbench.dir/Benchmarks/reactor.cpp.o.d"
+  "lab1reactorbench"
+  "lab1reactorbench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/lab1reactorbench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
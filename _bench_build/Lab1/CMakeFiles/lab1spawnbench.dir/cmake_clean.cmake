@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lab1spawnbench.dir/Benchmarks/spawn.cpp.o"
+  "CMakeFiles/lab1spawnbench.dir/Benchmarks/spawn.cpp.o.d"
+  "lab1spawnbench"
+  "lab1spawnbench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/lab1spawnbench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
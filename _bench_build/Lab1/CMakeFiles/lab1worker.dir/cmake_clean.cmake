@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lab1worker.dir/worker.cpp.o"
+  "CMakeFiles/lab1worker.dir/worker.cpp.o.d"
+  "lab1worker"
+  "lab1worker.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/lab1worker.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()